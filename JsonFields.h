@@ -0,0 +1,322 @@
+#ifndef JSON_FIELDS_H
+#define JSON_FIELDS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+/**
+ * @brief Declaration of a required field binding a JSON key to a member of C.
+ * @see   ValidatedJson::Required, FieldList
+ */
+template<typename C, typename T>
+struct RequiredField
+{
+  static constexpr bool kRequired = true;
+  using Type = T;
+
+  const char* key;
+  size_t length;
+  T C::* member;
+};
+
+/**
+ * @brief Declaration of an optional field binding a JSON key to a member of C.
+ *        The default value is assigned to the member when the key is absent.
+ * @see   ValidatedJson::Optional, FieldList
+ */
+template<typename C, typename T, typename D>
+struct OptionalField
+{
+  static constexpr bool kRequired = false;
+  using Type = T;
+
+  const char* key;
+  size_t length;
+  T C::* member;
+  D defaultValue;
+};
+
+/**
+ * @brief Key of a declared field and its position in the field list.
+ */
+struct FieldKey
+{
+  const char* key;
+  size_t length;
+  size_t index;
+};
+
+/**
+ * @brief Compare two keys by length first, then by content.
+ * @return Negative, zero or positive like strcmp.
+ */
+constexpr int CompareKeys(const char* a, size_t aLength, const char* b, size_t bLength)
+{
+  if (aLength != bLength) {
+    return aLength < bLength ? -1 : 1;
+  }
+  for (size_t i = 0; i < aLength; i++) {
+    if (a[i] != b[i]) {
+      return static_cast<unsigned char>(a[i]) < static_cast<unsigned char>(b[i]) ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Storage for the field at position I of a FieldList.
+ */
+template<size_t I, typename Field>
+struct FieldSlot
+{
+  Field field;
+};
+
+/**
+ * @brief Storage for every field of a FieldList, one base per field. Unlike
+ *        std::tuple, which is built up recursively, this stays quick to
+ *        compile for classes with hundreds of fields.
+ */
+template<typename Indices, typename... Fields>
+struct FieldSlots;
+
+template<size_t... I, typename... Fields>
+struct FieldSlots<std::index_sequence<I...>, Fields...> : FieldSlot<I, Fields>...
+{
+  constexpr FieldSlots(Fields... fields) :
+    FieldSlot<I, Fields>{fields}...
+  {}
+};
+
+/**
+ * @brief List of the fields a ValidatedJson subclass binds.
+ *        Built in a static constexpr Fields() function of the subclass,
+ *        which lets the key index be computed at compile time.
+ * @see   ValidatedJson::Bind
+ */
+template<typename... Fields>
+struct FieldList : FieldSlots<std::index_sequence_for<Fields...>, Fields...>
+{
+  static constexpr size_t kSize = sizeof...(Fields);
+
+  constexpr FieldList(Fields... fields) :
+    FieldSlots<std::index_sequence_for<Fields...>, Fields...>(fields...)
+  {}
+
+  /**
+   * @brief Get the field at a position in the list.
+   * @return The field declaration.
+   */
+  template<size_t I>
+  constexpr auto Get() const
+  {
+    return Slot<I>(*this);
+  }
+
+  /**
+   * @brief Get the keys of the fields in declaration order.
+   * @return std::array<FieldKey, kSize>
+   */
+  constexpr std::array<FieldKey, kSize> Keys() const
+  {
+    return Keys(std::index_sequence_for<Fields...>());
+  }
+
+private:
+  template<size_t I, typename Field>
+  static constexpr Field Slot(const FieldSlot<I, Field>& slot)
+  {
+    return slot.field;
+  }
+
+  template<size_t... I>
+  constexpr std::array<FieldKey, kSize> Keys(std::index_sequence<I...>) const
+  {
+    return {{FieldKey{Get<I>().key, Get<I>().length, I}...}};
+  }
+};
+
+/**
+ * @brief Scramble a hash (splitmix64 finaliser). Also used to combine a key
+ *        hash with a bucket seed without hashing the key again.
+ */
+constexpr uint64_t MixHash(uint64_t hash)
+{
+  hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+  hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+  return hash ^ (hash >> 31);
+}
+
+/**
+ * @brief Hash a key for the perfect hash table, eight bytes at a time.
+ */
+constexpr uint64_t HashKey(const char* key, size_t length)
+{
+  uint64_t hash = 0xcbf29ce484222325ull ^ length;
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    uint64_t word = 0;
+    for (size_t b = 0; b < 8; b++) {
+      word |= uint64_t(static_cast<unsigned char>(key[i + b])) << (8 * b);
+    }
+    hash = (hash ^ word) * 0x100000001b3ull;
+    hash ^= hash >> 29;
+  }
+  uint64_t tail = 0;
+  for (size_t b = 0; i + b < length; b++) {
+    tail |= uint64_t(static_cast<unsigned char>(key[i + b])) << (8 * b);
+  }
+  return MixHash(hash ^ tail);
+}
+
+/**
+ * @brief Perfect hash table over N keys, built at compile time by hash and
+ *        displace: keys are grouped into buckets by their hash, and each
+ *        bucket gets a seed which sends all of its keys to free slots.
+ *        A lookup costs one hash of the name and one key comparison.
+ */
+template<size_t N>
+struct PerfectHash
+{
+  // Table size: a power of two with room to spare, so seeds are found quickly
+  static constexpr size_t kSlots = [] {
+    size_t slots = 1;
+    while (slots < N + N / 2) {
+      slots *= 2;
+    }
+    return slots;
+  }();
+  static constexpr uint64_t kMask = kSlots - 1;
+  // Most seeds tried for a bucket before giving up
+  static constexpr uint64_t kMaxSeed = 4096;
+
+  struct Slot
+  {
+    const char* key = nullptr;
+    size_t length = 0;
+    int index = -1;
+  };
+
+  std::array<uint64_t, kSlots> seeds{};
+  std::array<Slot, kSlots> slots{};
+
+  /**
+   * @brief Build the table.
+   * @throws std::logic_error if a key is declared twice or no seed is found,
+   *         which fails the build when evaluated at compile time.
+   */
+  constexpr explicit PerfectHash(const std::array<FieldKey, N>& keys)
+  {
+    std::array<uint64_t, N> hashes{};
+    std::array<size_t, kSlots + 1> bucketStart{};
+    for (size_t i = 0; i < N; i++) {
+      hashes[i] = HashKey(keys[i].key, keys[i].length);
+      bucketStart[(hashes[i] & kMask) + 1]++;
+    }
+
+    // Group the keys by bucket. Equal keys hash alike, so duplicates can
+    // only be found within a bucket, which keeps the check short.
+    for (size_t b = 0; b < kSlots; b++) {
+      bucketStart[b + 1] += bucketStart[b];
+    }
+    std::array<size_t, N> members{};
+    std::array<size_t, kSlots> filled{};
+    for (size_t i = 0; i < N; i++) {
+      size_t b = hashes[i] & kMask;
+      for (size_t k = 0; k < filled[b]; k++) {
+        size_t j = members[bucketStart[b] + k];
+        if (hashes[j] == hashes[i] &&
+            CompareKeys(keys[i].key, keys[i].length, keys[j].key, keys[j].length) == 0) {
+          throw std::logic_error("Duplicate field key");
+        }
+      }
+      members[bucketStart[b] + filled[b]++] = i;
+    }
+
+    // Place the largest buckets first, while the table is still empty
+    size_t largest = 0;
+    for (size_t b = 0; b < kSlots; b++) {
+      largest = filled[b] > largest ? filled[b] : largest;
+    }
+    for (size_t size = largest; size > 0; size--) {
+      for (size_t b = 0; b < kSlots; b++) {
+        if (filled[b] != size) {
+          continue;
+        }
+        const size_t* bucket = &members[bucketStart[b]];
+        seeds[b] = FindSeed(hashes, bucket, size);
+        for (size_t k = 0; k < size; k++) {
+          size_t i = bucket[k];
+          Slot& slot = slots[MixHash(hashes[i] ^ seeds[b]) & kMask];
+          slot.key = keys[i].key;
+          slot.length = keys[i].length;
+          slot.index = static_cast<int>(keys[i].index);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Find the key matching a name.
+   * @param name Name to find, not necessarily null-terminated.
+   * @param length Length of name.
+   * @return The index stored with the key, or -1 if the name is not a key.
+   */
+  inline int Find(const char* name, size_t length) const
+  {
+    uint64_t hash = HashKey(name, length);
+    const Slot& slot = slots[MixHash(hash ^ seeds[hash & kMask]) & kMask];
+    if (slot.length != length || std::char_traits<char>::compare(slot.key, name, length) != 0) {
+      return -1;
+    }
+    return slot.index;
+  }
+
+private:
+  constexpr uint64_t FindSeed(const std::array<uint64_t, N>& hashes,
+                              const size_t* bucket, size_t count) const
+  {
+    // With the table at most two thirds full, a seed is found in a few tries
+    // unless two keys hash alike, which no seed separates
+    for (uint64_t seed = 1; seed <= kMaxSeed; seed++) {
+      bool fits = true;
+      for (size_t k = 0; k < count && fits; k++) {
+        uint64_t slot = MixHash(hashes[bucket[k]] ^ seed) & kMask;
+        fits = slots[slot].index < 0;
+        for (size_t j = 0; j < k && fits; j++) {
+          fits = slot != (MixHash(hashes[bucket[j]] ^ seed) & kMask);
+        }
+      }
+      if (fits) {
+        return seed;
+      }
+    }
+    throw std::logic_error("No perfect hash seed found");
+  }
+};
+
+/**
+ * @brief Compile-time index from member names to the fields of class C.
+ */
+template<typename C>
+struct FieldIndex
+{
+  static constexpr PerfectHash<decltype(C::Fields())::kSize> kHash{C::Fields().Keys()};
+
+  /**
+   * @brief Find the field declared for a member name.
+   * @param name Member name, not necessarily null-terminated.
+   * @param length Length of the member name.
+   * @return Position of the field in the field list, or -1 if not declared.
+   */
+  static inline int Find(const char* name, size_t length)
+  {
+    return kHash.Find(name, length);
+  }
+};
+
+#endif // JSON_FIELDS_H
@@ -0,0 +1,318 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "JsonIndex.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define JSON_INDEX_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+/**
+ * @brief Bitmasks of one 64-byte block, one bit per byte.
+ */
+struct BlockMasks
+{
+  uint64_t quote;
+  uint64_t backslash;
+  uint64_t op;
+  uint64_t whitespace;
+};
+
+/**
+ * @brief State carried from one block to the next, and the bit tricks which
+ *        turn the masks of a block into its structural positions. Shared by
+ *        every kernel; only classification and the prefix xor differ.
+ */
+struct BlockScanner
+{
+  uint64_t prevEscaped = 0;
+  uint64_t prevInString = 0;
+  uint64_t prevScalar = 0;
+
+  /**
+   * @brief Remove the quotes escaped by an odd run of backslashes.
+   *        Runs starting on odd bits are found by adding the run starts to
+   *        the backslashes, which carries across each run.
+   * @return Quotes which open or close a string.
+   */
+  inline uint64_t Quotes(const BlockMasks& masks)
+  {
+    const uint64_t evenBits = 0x5555555555555555ull;
+    uint64_t backslash = masks.backslash & ~prevEscaped;
+    uint64_t followsEscape = backslash << 1 | prevEscaped;
+    uint64_t oddStarts = backslash & ~evenBits & ~followsEscape;
+    unsigned long long evenSequences;
+    prevEscaped = __builtin_uaddll_overflow(oddStarts, backslash, &evenSequences);
+    uint64_t escaped = (evenBits ^ (evenSequences << 1)) & followsEscape;
+    return masks.quote & ~escaped;
+  }
+
+  /**
+   * @brief Find the structural positions of a block.
+   * @param quote Quotes from Quotes().
+   * @param quotePrefix Prefix xor of quote: set from each opening quote up
+   *        to, but not including, its closing quote.
+   * @return Structural positions as bits.
+   */
+  inline uint64_t Structurals(const BlockMasks& masks, uint64_t quote, uint64_t quotePrefix)
+  {
+    uint64_t inString = quotePrefix ^ prevInString;
+    prevInString = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+
+    // A scalar starts wherever a non-structural character doesn't follow one
+    uint64_t scalar = ~(masks.op | masks.whitespace);
+    uint64_t nonQuoteScalar = scalar & ~quote;
+    uint64_t followsScalar = nonQuoteScalar << 1 | prevScalar;
+    prevScalar = nonQuoteScalar >> 63;
+    uint64_t scalarStart = scalar & ~followsScalar;
+
+    // Nothing inside a string is structural, nor is its closing quote
+    uint64_t stringTail = inString ^ quote;
+    return (masks.op | scalarStart) & ~stringTail;
+  }
+};
+
+/**
+ * @brief Write the positions of the set bits.
+ */
+inline uint32_t* Flatten(uint32_t* out, uint32_t base, uint64_t bits)
+{
+  while (bits) {
+    *out++ = base + __builtin_ctzll(bits);
+    bits &= bits - 1;
+  }
+  return out;
+}
+
+inline uint64_t PrefixXorScalar(uint64_t bits)
+{
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+  return bits;
+}
+
+// Classes of bytes for the scalar kernel
+constexpr uint8_t kOp = 1;
+constexpr uint8_t kWhitespace = 2;
+constexpr uint8_t kQuote = 4;
+constexpr uint8_t kBackslash = 8;
+
+struct ByteClasses
+{
+  uint8_t classes[256] = {};
+
+  constexpr ByteClasses()
+  {
+    for (char c : {'{', '}', '[', ']', ':', ','}) {
+      classes[static_cast<uint8_t>(c)] = kOp;
+    }
+    for (char c : {' ', '\t', '\n', '\r'}) {
+      classes[static_cast<uint8_t>(c)] = kWhitespace;
+    }
+    classes[static_cast<uint8_t>('"')] = kQuote;
+    classes[static_cast<uint8_t>('\\')] = kBackslash;
+  }
+};
+
+constexpr ByteClasses kByteClasses;
+
+BlockMasks ClassifyScalar(const uint8_t* block)
+{
+  BlockMasks masks{};
+  for (unsigned i = 0; i < 64; i++) {
+    uint8_t c = kByteClasses.classes[block[i]];
+    masks.op |= uint64_t(c & kOp) << i;
+    masks.whitespace |= uint64_t((c & kWhitespace) >> 1) << i;
+    masks.quote |= uint64_t((c & kQuote) >> 2) << i;
+    masks.backslash |= uint64_t((c & kBackslash) >> 3) << i;
+  }
+  return masks;
+}
+
+#ifdef JSON_INDEX_X86
+// Vector classification: whitespace and operators are found with a table
+// lookup on the low nibble of each byte. Setting bit 5 folds '[' and ']'
+// onto '{' and '}', so six operators need four table entries.
+#define JSON_INDEX_WHITESPACE_TABLE \
+  ' ', 0, 0, 0, 0, 0, 0, 0, 0, '\t', '\n', 0, 0, '\r', 0, 0
+#define JSON_INDEX_OP_TABLE \
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, ':', '{', ',', '}', 0, 0
+
+__attribute__((target("sse4.2,pclmul")))
+inline BlockMasks ClassifySse42(const uint8_t* block)
+{
+  const __m128i whitespaceTable = _mm_setr_epi8(JSON_INDEX_WHITESPACE_TABLE);
+  const __m128i opTable = _mm_setr_epi8(JSON_INDEX_OP_TABLE);
+  BlockMasks masks{};
+  for (unsigned i = 0; i < 4; i++) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+    __m128i whitespace = _mm_cmpeq_epi8(_mm_shuffle_epi8(whitespaceTable, in), in);
+    __m128i op = _mm_cmpeq_epi8(_mm_shuffle_epi8(opTable, in), _mm_or_si128(in, _mm_set1_epi8(0x20)));
+    masks.whitespace |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(whitespace))) << (16 * i);
+    masks.op |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(op))) << (16 * i);
+    masks.quote |= uint64_t(static_cast<uint16_t>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(in, _mm_set1_epi8('"'))))) << (16 * i);
+    masks.backslash |= uint64_t(static_cast<uint16_t>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(in, _mm_set1_epi8('\\'))))) << (16 * i);
+  }
+  return masks;
+}
+
+__attribute__((target("avx2,bmi,pclmul")))
+inline BlockMasks ClassifyAvx2(const uint8_t* block)
+{
+  const __m256i whitespaceTable = _mm256_setr_epi8(JSON_INDEX_WHITESPACE_TABLE, JSON_INDEX_WHITESPACE_TABLE);
+  const __m256i opTable = _mm256_setr_epi8(JSON_INDEX_OP_TABLE, JSON_INDEX_OP_TABLE);
+  BlockMasks masks{};
+  for (unsigned i = 0; i < 2; i++) {
+    __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32 * i));
+    __m256i whitespace = _mm256_cmpeq_epi8(_mm256_shuffle_epi8(whitespaceTable, in), in);
+    __m256i op = _mm256_cmpeq_epi8(_mm256_shuffle_epi8(opTable, in),
+                                   _mm256_or_si256(in, _mm256_set1_epi8(0x20)));
+    masks.whitespace |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(whitespace))) << (32 * i);
+    masks.op |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(op))) << (32 * i);
+    masks.quote |= uint64_t(static_cast<uint32_t>(
+      _mm256_movemask_epi8(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('"'))))) << (32 * i);
+    masks.backslash |= uint64_t(static_cast<uint32_t>(
+      _mm256_movemask_epi8(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('\\'))))) << (32 * i);
+  }
+  return masks;
+}
+
+#undef JSON_INDEX_WHITESPACE_TABLE
+#undef JSON_INDEX_OP_TABLE
+
+__attribute__((target("pclmul")))
+inline uint64_t PrefixXorClmul(uint64_t bits)
+{
+  __m128i product = _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<int64_t>(bits)),
+                                         _mm_set1_epi8(static_cast<char>(0xFF)), 0);
+  return static_cast<uint64_t>(_mm_cvtsi128_si64(product));
+}
+#endif
+
+/**
+ * @brief Copy the last partial block, padded with whitespace.
+ */
+inline const uint8_t* PadTail(const uint8_t* data, size_t size, size_t offset, uint8_t* tail)
+{
+  std::memset(tail, ' ', 64);
+  std::memcpy(tail, data + offset, size - offset);
+  return tail;
+}
+
+// One loop per kernel, so that each is compiled for its instruction set
+
+bool IndexScalar(const uint8_t* data, size_t size, uint32_t*& out)
+{
+  BlockScanner scanner;
+  uint8_t tail[64];
+  for (size_t offset = 0; offset < size; offset += 64) {
+    const uint8_t* block = size - offset >= 64 ? data + offset : PadTail(data, size, offset, tail);
+    BlockMasks masks = ClassifyScalar(block);
+    uint64_t quote = scanner.Quotes(masks);
+    out = Flatten(out, offset, scanner.Structurals(masks, quote, PrefixXorScalar(quote)));
+  }
+  return scanner.prevInString == 0;
+}
+
+#ifdef JSON_INDEX_X86
+__attribute__((target("sse4.2,pclmul")))
+bool IndexSse42(const uint8_t* data, size_t size, uint32_t*& out)
+{
+  BlockScanner scanner;
+  uint8_t tail[64];
+  for (size_t offset = 0; offset < size; offset += 64) {
+    const uint8_t* block = size - offset >= 64 ? data + offset : PadTail(data, size, offset, tail);
+    BlockMasks masks = ClassifySse42(block);
+    uint64_t quote = scanner.Quotes(masks);
+    out = Flatten(out, offset, scanner.Structurals(masks, quote, PrefixXorClmul(quote)));
+  }
+  return scanner.prevInString == 0;
+}
+
+__attribute__((target("avx2,bmi,pclmul")))
+bool IndexAvx2(const uint8_t* data, size_t size, uint32_t*& out)
+{
+  BlockScanner scanner;
+  uint8_t tail[64];
+  for (size_t offset = 0; offset < size; offset += 64) {
+    const uint8_t* block = size - offset >= 64 ? data + offset : PadTail(data, size, offset, tail);
+    BlockMasks masks = ClassifyAvx2(block);
+    uint64_t quote = scanner.Quotes(masks);
+    out = Flatten(out, offset, scanner.Structurals(masks, quote, PrefixXorClmul(quote)));
+  }
+  return scanner.prevInString == 0;
+}
+#endif
+}
+
+bool JsonIndex::Build(const char* data, size_t size, Kernel kernel)
+{
+  if (size >= UINT32_MAX)
+  {
+    throw std::length_error("JSON text too large to index");
+  }
+
+  // At most one position per byte, plus the sentinel
+  if (_capacity < size + 1)
+  {
+    _capacity = size + 1 + size / 2;
+    _positions.reset(new uint32_t[_capacity]);
+  }
+
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  uint32_t* out = _positions.get();
+  bool closed;
+  switch (kernel)
+  {
+#ifdef JSON_INDEX_X86
+    case Kernel::Avx2:
+      closed = IndexAvx2(bytes, size, out);
+      break;
+    case Kernel::Sse42:
+      closed = IndexSse42(bytes, size, out);
+      break;
+#endif
+    default:
+      closed = IndexScalar(bytes, size, out);
+      break;
+  }
+
+  _size = out - _positions.get();
+  *out = static_cast<uint32_t>(size);
+  return closed;
+}
+
+JsonIndex::Kernel JsonIndex::BestKernel()
+{
+  static const Kernel best = Supported(Kernel::Avx2) ? Kernel::Avx2
+                           : Supported(Kernel::Sse42) ? Kernel::Sse42
+                           : Kernel::Scalar;
+  return best;
+}
+
+bool JsonIndex::Supported(Kernel kernel)
+{
+  switch (kernel)
+  {
+#ifdef JSON_INDEX_X86
+    case Kernel::Avx2:
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi") &&
+             __builtin_cpu_supports("pclmul");
+    case Kernel::Sse42:
+      return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("pclmul");
+#endif
+    case Kernel::Scalar:
+      return true;
+    default:
+      return false;
+  }
+}
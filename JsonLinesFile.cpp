@@ -0,0 +1,92 @@
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "JsonLinesFile.h"
+
+LineReader::LineReader(const std::string& path, size_t bufferSize) :
+  _path(path),
+  _fd(open(path.c_str(), O_RDONLY | O_CLOEXEC)),
+  _buffer(new char[bufferSize > 0 ? bufferSize : 1]),
+  _capacity(bufferSize > 0 ? bufferSize : 1)
+{
+  if (_fd < 0)
+  {
+    throw std::runtime_error("Could not open JSON file: " + path);
+  }
+#ifdef POSIX_FADV_SEQUENTIAL
+  posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+LineReader::~LineReader()
+{
+  close(_fd);
+}
+
+bool LineReader::NextLine(std::string_view& line)
+{
+  size_t searched = _begin;
+  for (;;)
+  {
+    const char* start = _buffer.get() + _begin;
+    const void* newline = std::memchr(_buffer.get() + searched, '\n', _end - searched);
+    if (newline || (_eof && _begin != _end))
+    {
+      // The last line of a file need not end with a newline
+      const char* stop = newline ? static_cast<const char*>(newline) : _buffer.get() + _end;
+      _begin = stop - _buffer.get() + (newline ? 1 : 0);
+      if (stop != start && stop[-1] == '\r')
+      {
+        stop--;
+      }
+      line = std::string_view(start, stop - start);
+      _lineNumber++;
+      return true;
+    }
+    if (_eof)
+    {
+      return false;
+    }
+
+    // Only the new bytes need searching once more are read
+    searched = _end - _begin;
+    Fill();
+    searched += _begin;
+  }
+}
+
+void LineReader::Fill()
+{
+  // Keep the unread part of the current line at the front of the buffer
+  size_t unread = _end - _begin;
+  if (unread == _capacity)
+  {
+    std::unique_ptr<char[]> grown(new char[_capacity * 2]);
+    std::memcpy(grown.get(), _buffer.get() + _begin, unread);
+    _buffer = std::move(grown);
+    _capacity *= 2;
+  }
+  else if (_begin != 0)
+  {
+    std::memmove(_buffer.get(), _buffer.get() + _begin, unread);
+  }
+  _begin = 0;
+  _end = unread;
+
+  ssize_t count;
+  do
+  {
+    count = read(_fd, _buffer.get() + _end, _capacity - _end);
+  } while (count < 0 && errno == EINTR);
+  if (count < 0)
+  {
+    throw std::runtime_error("Could not read JSON file: " + _path);
+  }
+  _end += count;
+  _eof = count == 0;
+}
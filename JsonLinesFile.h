@@ -0,0 +1,135 @@
+#ifndef JSON_LINES_FILE_H
+#define JSON_LINES_FILE_H
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "ValidatedJson.h"
+
+/**
+ * @brief Reads a file one line at a time through a buffer which is reused
+ *        for every line, so files of any size are read in bounded memory.
+ *        The buffer only grows to hold a line longer than itself.
+ *        Works on pipes and special files as well as regular files.
+ * @see   JsonLinesFile
+ */
+class LineReader
+{
+public:
+  /**
+   * @brief Constructor that opens a file.
+   * @param path Path to the file.
+   * @param bufferSize Initial size of the buffer.
+   * @throws std::runtime_error if the file cannot be opened.
+   */
+  explicit LineReader(const std::string& path, size_t bufferSize = 1 << 20);
+
+  ~LineReader();
+
+  LineReader(const LineReader&) = delete;
+  LineReader& operator=(const LineReader&) = delete;
+
+  /**
+   * @brief Read the next line.
+   * @param line Set to the line without its "\n" or "\r\n"; valid until the
+   *        next call.
+   * @return false at the end of the file.
+   * @throws std::runtime_error if the file cannot be read.
+   */
+  bool NextLine(std::string_view& line);
+
+  /**
+   * @brief Get the number of the last line read, counting from 1.
+   * @return size_t
+   */
+  inline size_t LineNumber() const { return _lineNumber; }
+
+private:
+  /**
+   * @brief Move the unread bytes to the front of the buffer, growing it if
+   *        they fill it, and read more after them.
+   */
+  void Fill();
+
+  std::string _path;
+  int _fd;
+  std::unique_ptr<char[]> _buffer;
+  size_t _capacity;
+
+  // Unread bytes are [_begin, _end) of the buffer
+  size_t _begin = 0;
+  size_t _end = 0;
+  bool _eof = false;
+  size_t _lineNumber = 0;
+};
+
+/**
+ * @brief Record read from one line of a JSON Lines file.
+ */
+template<typename T>
+struct JsonLine
+{
+  size_t number;                ///< Line number in the file, counting from 1.
+  ValidationResult<T> result;   ///< The bound record, or why it could not be bound.
+};
+
+/**
+ * @brief Reader of newline-delimited JSON (JSON Lines, NDJSON) which binds
+ *        each line to a T as it is read, in bounded memory.
+ *        Each line is bound straight from the text, as with JsonText, so it
+ *        must be RFC 8259 JSON. A line which fails to parse or validate is
+ *        reported in its JsonLine and reading carries on with the next one.
+ *        Blank lines are skipped. Like the line buffer, the structural index
+ *        and scratch space are reused for every line.
+ * @see   LineReader, Validate
+ */
+template<typename T>
+class JsonLinesFile
+{
+public:
+  /**
+   * @brief Constructor that opens a file.
+   * @param path Path to the file.
+   * @param mode Whether to stop at the first error in a line or collect all.
+   * @param parser Parser whose settings to read with, by default the calling
+   *        thread's parser; must outlive the reader.
+   * @param bufferSize Initial size of the line buffer.
+   * @throws std::runtime_error if the file cannot be opened.
+   */
+  explicit JsonLinesFile(const std::string& path, ValidationMode mode = ValidationMode::FirstError,
+                         JsonParser& parser = JsonParser::ThreadLocal(), size_t bufferSize = 1 << 20) :
+    _lines(path, bufferSize),
+    _mode(mode),
+    _parser(parser)
+  {}
+
+  /**
+   * @brief Read and bind the next record.
+   * @return The record and its line number, or nothing at the end of the file.
+   * @throws std::runtime_error if the file cannot be read.
+   */
+  std::optional<JsonLine<T>> Next()
+  {
+    std::string_view line;
+    while (_lines.NextLine(line)) {
+      if (line.find_first_not_of(" \t\r") == std::string_view::npos) {
+        continue;
+      }
+      return JsonLine<T>{_lines.LineNumber(), ValidateText<T>(line, _mode, _parser.GetSettings(), _buffers)};
+    }
+    return std::nullopt;
+  }
+
+private:
+  LineReader _lines;
+  ValidationMode _mode;
+  JsonParser& _parser;
+
+  // Index and scratch buffers kept from line to line
+  JsonTextBuffers _buffers;
+};
+
+#endif // JSON_LINES_FILE_H
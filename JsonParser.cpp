@@ -0,0 +1,145 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <json/json.h>
+
+#include "JsonParser.h"
+#include "JsonReader.h"
+#include "Utf8Validator.h"
+
+namespace
+{
+/**
+ * @brief Check that a whole text is valid UTF-8.
+ * @return false, with the position of the first invalid sequence in errors,
+ *         if it is not.
+ */
+bool CheckUtf8(const char* begin, const char* end, std::string& errors)
+{
+  size_t size = end - begin;
+  if (Utf8Validator::Valid(begin, size))
+  {
+    return true;
+  }
+  const char* invalid = begin + Utf8Validator::FindInvalid(begin, size);
+  errors = JsonSyntaxError::At(begin, invalid, "Invalid UTF-8").Details();
+  return false;
+}
+
+/**
+ * @brief Backend parsing with jsoncpp's CharReader.
+ */
+class JsoncppBackend : public JsonParserBackend
+{
+public:
+  explicit JsoncppBackend(const JsonParserSettings& settings) :
+    _checkUtf8(settings.utf8 == Utf8Validation::PerString)
+  {
+    Json::CharReaderBuilder builder;
+    if (settings.strict)
+    {
+      Json::CharReaderBuilder::strictMode(&builder.settings_);
+    }
+    // jsoncpp limits the depth of values, counting the root as 1, so a
+    // scalar inside depthLimit containers needs one more
+    builder["stackLimit"] = settings.depthLimit + 1;
+    builder["rejectDupKeys"] = settings.rejectDuplicateKeys;
+    _reader.reset(builder.newCharReader());
+  }
+
+  bool Parse(const char* begin, const char* end, Json::Value& root, std::string& errors) override
+  {
+    // jsoncpp can't check strings as it reads them, so the whole text is checked
+    if (_checkUtf8 && !CheckUtf8(begin, end, errors))
+    {
+      return false;
+    }
+    try
+    {
+      return _reader->parse(begin, end, &root, &errors);
+    }
+    catch (const Json::Exception& e)
+    {
+      // jsoncpp throws rather than reporting when the depth limit is exceeded
+      errors = e.what();
+      return false;
+    }
+  }
+
+private:
+  std::unique_ptr<Json::CharReader> _reader;
+  bool _checkUtf8;
+};
+
+/**
+ * @brief Backend parsing with the built-in JsonReader.
+ */
+class BuiltinBackend : public JsonParserBackend
+{
+public:
+  explicit BuiltinBackend(const JsonParserSettings& settings) :
+    _settings(settings)
+  {}
+
+  bool Parse(const char* begin, const char* end, Json::Value& root, std::string& errors) override
+  {
+    try
+    {
+      // Without a complete index the reader finds the unclosed string itself
+      const JsonIndex* index = nullptr;
+      if (_settings.structuralIndex && end - begin < UINT32_MAX && _index.Build(begin, end - begin))
+      {
+        index = &_index;
+      }
+
+      JsonReader reader(begin, end, _settings, index);
+      reader.ReadValue(root);
+      reader.Finish();
+      return true;
+    }
+    catch (const JsonSyntaxError& e)
+    {
+      errors = e.Details();
+      return false;
+    }
+  }
+
+private:
+  JsonParserSettings _settings;
+  JsonIndex _index;
+};
+}
+
+std::unique_ptr<JsonParserBackend> JsonParserBackend::Create(const JsonParserSettings& settings)
+{
+  if (settings.backend == JsonBackend::Builtin)
+  {
+    return std::make_unique<BuiltinBackend>(settings);
+  }
+  return std::make_unique<JsoncppBackend>(settings);
+}
+
+JsonParser::JsonParser(const JsonParserSettings& settings) :
+  _settings(settings),
+  _backend(JsonParserBackend::Create(settings))
+{}
+
+JsonParser::JsonParser(std::unique_ptr<JsonParserBackend> backend, const JsonParserSettings& settings) :
+  _settings(settings),
+  _backend(std::move(backend))
+{}
+
+bool JsonParser::Parse(const char* begin, const char* end, Json::Value& root, std::string& errors)
+{
+  if (_settings.utf8 == Utf8Validation::Buffer && !CheckUtf8(begin, end, errors))
+  {
+    return false;
+  }
+  return _backend->Parse(begin, end, root, errors);
+}
+
+JsonParser& JsonParser::ThreadLocal()
+{
+  thread_local JsonParser parser;
+  return parser;
+}
@@ -0,0 +1,142 @@
+#ifndef JSON_PARSER_H
+#define JSON_PARSER_H
+
+#include <memory>
+#include <string>
+#include <json/json.h>
+
+/**
+ * @brief Engine used to parse JSON text into a Json::Value.
+ * @see   JsonParserSettings, JsonParserBackend
+ */
+enum class JsonBackend
+{
+  Jsoncpp,  ///< jsoncpp's CharReader.
+  Builtin   ///< The library's own single-pass reader, see JsonReader.
+};
+
+/**
+ * @brief Backend used when the settings don't name one. Chosen at build time
+ *        with the VALIDATED_JSON_BACKEND CMake option.
+ */
+#ifdef VALIDATED_JSON_BUILTIN_BACKEND
+constexpr JsonBackend kDefaultJsonBackend = JsonBackend::Builtin;
+#else
+constexpr JsonBackend kDefaultJsonBackend = JsonBackend::Jsoncpp;
+#endif
+
+/**
+ * @brief How JSON text is checked to be valid UTF-8.
+ * @see   JsonParserSettings, Utf8Validator
+ */
+enum class Utf8Validation
+{
+  None,       ///< Not checked; bytes are passed through as they are.
+  PerString,  ///< Each string is checked as it is read.
+  Buffer      ///< The whole text is checked with SIMD before it is read, so strings aren't checked again.
+};
+
+/**
+ * @brief Settings for parsing JSON text.
+ *        The builtin backend is always strict. jsoncpp is lenient unless
+ *        strict is set, and even then accepts a comment straight after the
+ *        value of an object member. jsoncpp also accepts an empty array or
+ *        object one level past depthLimit.
+ *        With onDemand, members which no field asks for are skipped by
+ *        matching brackets without checking their syntax, so an error inside
+ *        one of them is not reported.
+ * @see   JsonParser
+ */
+struct JsonParserSettings
+{
+  unsigned depthLimit = 1000;        ///< Maximum nesting depth of arrays and objects.
+  bool strict = false;               ///< Strict RFC 8259: no comments, trailing commas or extra text.
+  bool rejectDuplicateKeys = false;  ///< Fail on duplicate object keys rather than keeping the last.
+  JsonBackend backend = kDefaultJsonBackend;  ///< Engine to parse with.
+  bool structuralIndex = false;      ///< Index the text with SIMD before reading it with JsonReader.
+  Utf8Validation utf8 = Utf8Validation::None;  ///< How to check that the text is valid UTF-8.
+  bool onDemand = false;             ///< Skip unrequested members when binding from JsonText.
+};
+
+/**
+ * @brief Interface of a parsing engine. Any engine which can produce a
+ *        Json::Value can be plugged into a JsonParser, and everything bound
+ *        through it works unchanged.
+ * @see   JsonParser
+ */
+class JsonParserBackend
+{
+public:
+  virtual ~JsonParserBackend() = default;
+
+  /**
+   * @brief Parse JSON text without throwing.
+   * @param begin Start of the JSON text.
+   * @param end End of the JSON text.
+   * @param root Value to store the parsed document in.
+   * @param errors String to store error messages in.
+   * @return true if parsing succeeded.
+   */
+  virtual bool Parse(const char* begin, const char* end, Json::Value& root, std::string& errors) = 0;
+
+  /**
+   * @brief Create one of the backends supplied with the library.
+   * @param settings Settings, including the backend to create.
+   * @return std::unique_ptr<JsonParserBackend>
+   */
+  static std::unique_ptr<JsonParserBackend> Create(const JsonParserSettings& settings);
+};
+
+/**
+ * @brief Reusable parser context. Creating a parser is far more expensive
+ *        than parsing a small document, so a parser is kept and reused for
+ *        every document parsed with it.
+ *        A JsonParser is not thread-safe; use one per thread, for example
+ *        the one returned by ThreadLocal().
+ * @see   JsonData, JsonFile, JsonString
+ */
+class JsonParser
+{
+public:
+  /**
+   * @brief Constructor that creates a parser with the given settings.
+   * @param settings Parser settings.
+   */
+  explicit JsonParser(const JsonParserSettings& settings = JsonParserSettings());
+
+  /**
+   * @brief Constructor that parses with a backend supplied by the caller.
+   * @param backend Backend to parse with.
+   * @param settings Parser settings, for those who ask the parser for them.
+   */
+  JsonParser(std::unique_ptr<JsonParserBackend> backend,
+             const JsonParserSettings& settings = JsonParserSettings());
+
+  /**
+   * @brief Parse JSON text without throwing.
+   * @param begin Start of the JSON text.
+   * @param end End of the JSON text.
+   * @param root Value to store the parsed document in.
+   * @param errors String to store error messages in.
+   * @return true if parsing succeeded.
+   */
+  bool Parse(const char* begin, const char* end, Json::Value& root, std::string& errors);
+
+  /**
+   * @brief Get the settings the parser was created with.
+   * @return const JsonParserSettings&
+   */
+  inline const JsonParserSettings& GetSettings() const { return _settings; }
+
+  /**
+   * @brief Get the calling thread's parser with default settings.
+   * @return JsonParser&
+   */
+  static JsonParser& ThreadLocal();
+
+private:
+  JsonParserSettings _settings;
+  std::unique_ptr<JsonParserBackend> _backend;
+};
+
+#endif // JSON_PARSER_H
@@ -0,0 +1,413 @@
+#include <stdexcept>
+#include <string>
+#include <json/json.h>
+
+#include "JsonPushParser.h"
+
+JsonPushParser::JsonPushParser(const JsonParserSettings& settings) :
+  _settings(settings),
+  _tokenSettings(settings)
+{
+  // A token is read on its own, where the strict root check does not apply
+  _tokenSettings.strict = false;
+  _tokenSettings.structuralIndex = false;
+  if (_tokenSettings.utf8 == Utf8Validation::Buffer)
+  {
+    _tokenSettings.utf8 = Utf8Validation::PerString;
+  }
+}
+
+size_t JsonPushParser::Feed(const char* data, size_t size)
+{
+  const char* position = data;
+  const char* end = data + size;
+  _chunk = data;
+
+  if (_token != Token::None)
+  {
+    // Carry on with the token the last chunk ended in
+    _tokenStart = data;
+    position = ReadToken(data, end);
+  }
+
+  while (position != end && _expect != Expect::End)
+  {
+    if (!IsWhitespace(*position))
+    {
+      position = Step(position, end);
+    }
+    else
+    {
+      if (*position == '\n')
+      {
+        _line++;
+        _lineStart = _offset + (position - data) + 1;
+      }
+      position++;
+    }
+  }
+
+  _offset += position - data;
+  return position - data;
+}
+
+void JsonPushParser::Finish()
+{
+  _chunk = nullptr;
+  if (_token == Token::Number)
+  {
+    // Nothing but the end of the input ends a number at the top level
+    EndToken(_partial.data(), _partial.data() + _partial.size());
+    _partial.clear();
+  }
+
+  switch (_token)
+  {
+    case Token::Name:
+    case Token::String:
+      Error(nullptr, "Missing '\"' at end of string");
+    case Token::Literal:
+      throw JsonSyntaxError(_tokenLine, _tokenColumn, "Syntax error: value, object or array expected");
+    default:
+      break;
+  }
+  if (_expect == Expect::Value || _expect == Expect::FirstElement)
+  {
+    Error(nullptr, "Unexpected end of input, expected a value");
+  }
+  if (_expect != Expect::End)
+  {
+    Error(nullptr, Missing());
+  }
+}
+
+Json::Value JsonPushParser::Take()
+{
+  if (!Done())
+  {
+    throw std::runtime_error("JSON document has not ended");
+  }
+  Json::Value root = std::move(_root);
+  Restart();
+  return root;
+}
+
+void JsonPushParser::Reset()
+{
+  Restart();
+  _chunk = nullptr;
+  _offset = 0;
+  _line = 1;
+  _lineStart = 0;
+}
+
+void JsonPushParser::Restart()
+{
+  _root = Json::Value();
+  _stack.clear();
+  _member = nullptr;
+  _expect = Expect::Value;
+  _started = false;
+  _token = Token::None;
+  _partial.clear();
+  _escaped = false;
+}
+
+const char* JsonPushParser::Step(const char* position, const char* end)
+{
+  char c = *position;
+  switch (_expect)
+  {
+    case Expect::FirstElement:
+      if (c == ']')
+      {
+        Close();
+        return position + 1;
+      }
+      return BeginValue(position, end);
+    case Expect::Value:
+      return BeginValue(position, end);
+    case Expect::FirstMember:
+      if (c == '}')
+      {
+        Close();
+        return position + 1;
+      }
+      // After a comma only a member name may follow, which rejects trailing commas
+      [[fallthrough]];
+    case Expect::Member:
+      if (c != '"')
+      {
+        Error(position, Missing());
+      }
+      return BeginToken(Token::Name, position, end);
+    case Expect::Colon:
+    {
+      if (c != ':')
+      {
+        Error(position, Missing());
+      }
+      Json::Value& object = *_stack.back();
+      if (_settings.rejectDuplicateKeys && object.isMember(_name))
+      {
+        Error(position + 1, "Duplicate key: '" + _name + "'");
+      }
+      _member = &object[_name];
+      _expect = Expect::Value;
+      return position + 1;
+    }
+    case Expect::Comma:
+    {
+      bool object = _stack.back()->isObject();
+      if (c == ',')
+      {
+        _expect = object ? Expect::Member : Expect::Value;
+        return position + 1;
+      }
+      if (c != (object ? '}' : ']'))
+      {
+        Error(position, Missing());
+      }
+      Close();
+      return position + 1;
+    }
+    default:
+      return position;
+  }
+}
+
+const char* JsonPushParser::BeginValue(const char* position, const char* end)
+{
+  Token token;
+  switch (*position)
+  {
+    case '{':
+    case '[':
+      _started = true;
+      Open(*position == '{', position);
+      return position + 1;
+    case '"':
+      token = Token::String;
+      break;
+    case 't': case 'f': case 'n':
+      token = Token::Literal;
+      break;
+    case '-': case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+      token = Token::Number;
+      break;
+    default:
+      Error(position, "Syntax error: value, object or array expected");
+  }
+
+  if (_stack.empty() && _settings.strict)
+  {
+    Error(position, "A valid JSON document must be either an array or an object value");
+  }
+  _started = true;
+  return BeginToken(token, position, end);
+}
+
+const char* JsonPushParser::BeginToken(Token token, const char* position, const char* end)
+{
+  _token = token;
+  _tokenStart = position;
+  _tokenLine = _line;
+  _tokenColumn = Column(position);
+  _escaped = false;
+
+  switch (token)
+  {
+    case Token::Name:
+    case Token::String:
+      // Past the opening quote
+      return ReadToken(position + 1, end);
+    case Token::Literal:
+      _literal = *position == 't' ? "true" : *position == 'f' ? "false" : "null";
+      _matched = 0;
+      return ReadToken(position, end);
+    default:
+      return ReadToken(position, end);
+  }
+}
+
+const char* JsonPushParser::ReadToken(const char* position, const char* end)
+{
+  // Find the end of the token, or the end of the chunk if it goes on past it
+  const char* stop = nullptr;
+  switch (_token)
+  {
+    case Token::Name:
+    case Token::String:
+      for (; position != end && !stop; position++)
+      {
+        if (_escaped)
+        {
+          _escaped = false;
+        }
+        else if (*position == '\\')
+        {
+          _escaped = true;
+        }
+        else if (*position == '"')
+        {
+          stop = position + 1;
+        }
+      }
+      break;
+    case Token::Number:
+      while (position != end && ((*position >= '0' && *position <= '9') || *position == '-' ||
+                                 *position == '+' || *position == '.' || *position == 'e' || *position == 'E'))
+      {
+        position++;
+      }
+      if (position != end)
+      {
+        stop = position;
+      }
+      break;
+    case Token::Literal:
+      for (; position != end && _literal[_matched] != 0; position++, _matched++)
+      {
+        if (*position != _literal[_matched])
+        {
+          throw JsonSyntaxError(_tokenLine, _tokenColumn, "Syntax error: value, object or array expected");
+        }
+      }
+      if (_literal[_matched] == 0)
+      {
+        stop = position;
+      }
+      break;
+    default:
+      break;
+  }
+
+  if (!stop)
+  {
+    _partial.append(_tokenStart, end);
+    return end;
+  }
+  if (_partial.empty())
+  {
+    EndToken(_tokenStart, stop);
+  }
+  else
+  {
+    _partial.append(_tokenStart, stop);
+    EndToken(_partial.data(), _partial.data() + _partial.size());
+    _partial.clear();
+  }
+  return stop;
+}
+
+void JsonPushParser::EndToken(const char* begin, const char* end)
+{
+  Token token = _token;
+  _token = Token::None;
+
+  if (token == Token::Literal)
+  {
+    Json::Value& value = Slot();
+    value = _literal[0] == 'n' ? Json::Value() : Json::Value(_literal[0] == 't');
+    EndValue();
+    return;
+  }
+
+  // Strings and numbers are read by a JsonReader over the token alone
+  JsonReader reader(begin, end, _tokenSettings);
+  std::string_view name;
+  const char* stop = end;
+  try
+  {
+    if (token == Token::Name)
+    {
+      name = reader.ReadString();
+    }
+    else
+    {
+      reader.ReadValue(Slot());
+    }
+    stop = reader.Position();
+  }
+  catch (const JsonSyntaxError& e)
+  {
+    // Only a string with a raw newline in it, which is an error anyway, spans lines
+    size_t line = _tokenLine + e.Line() - 1;
+    throw JsonSyntaxError(line, e.Line() > 1 ? e.Column() : _tokenColumn + e.Column() - 1, e.Message());
+  }
+
+  if (token == Token::Name)
+  {
+    _name.assign(name);
+    _expect = Expect::Colon;
+    return;
+  }
+
+  EndValue();
+  if (stop != end)
+  {
+    // A number such as "01" or "1-2" ends where the reader stopped, and what
+    // follows it cannot follow a value
+    throw JsonSyntaxError(_tokenLine, _tokenColumn + (stop - begin), Missing());
+  }
+}
+
+void JsonPushParser::Open(bool object, const char* position)
+{
+  if (_stack.size() >= _settings.depthLimit)
+  {
+    Error(position, "Exceeded stack limit");
+  }
+  Json::Value& value = Slot();
+  value = Json::Value(object ? Json::objectValue : Json::arrayValue);
+  _stack.push_back(&value);
+  _expect = object ? Expect::FirstMember : Expect::FirstElement;
+}
+
+void JsonPushParser::Close()
+{
+  _stack.pop_back();
+  EndValue();
+}
+
+void JsonPushParser::EndValue()
+{
+  _expect = _stack.empty() ? Expect::End : Expect::Comma;
+}
+
+Json::Value& JsonPushParser::Slot()
+{
+  if (_stack.empty())
+  {
+    return _root;
+  }
+  Json::Value& container = *_stack.back();
+  if (container.isArray())
+  {
+    return container.append(Json::Value());
+  }
+  return *_member;
+}
+
+const char* JsonPushParser::Missing() const
+{
+  switch (_expect)
+  {
+    case Expect::FirstMember:
+    case Expect::Member:
+      return "Missing '}' or object member name";
+    case Expect::Colon:
+      return "Missing ':' after object member name";
+    case Expect::Comma:
+      return _stack.back()->isObject() ? "Missing ',' or '}' in object declaration"
+                                       : "Missing ',' or ']' in array declaration";
+    default:
+      return "Extra non-whitespace after JSON value";
+  }
+}
+
+void JsonPushParser::Error(const char* position, const std::string& message) const
+{
+  throw JsonSyntaxError(_line, Column(position), message);
+}
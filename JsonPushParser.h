@@ -0,0 +1,279 @@
+#ifndef JSON_PUSH_PARSER_H
+#define JSON_PUSH_PARSER_H
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <json/json.h>
+
+#include "JsonParser.h"
+#include "JsonReader.h"
+#include "ValidatedJson.h"
+
+/**
+ * @brief Parser which is fed JSON text in chunks of any size as they arrive,
+ *        from a socket or pipe for example, and builds the document as it
+ *        goes. Its state is kept between chunks on a stack of its own, and
+ *        only a token split between two chunks is copied, so reading and
+ *        parsing overlap and the text as a whole is never held.
+ *        The text is parsed as RFC 8259 JSON with the checks and messages of
+ *        JsonReader. Lines and columns in errors count from the first byte
+ *        fed. Utf8Validation::Buffer checks each string, as PerString does,
+ *        since there is never a whole buffer to check.
+ *        One document is read at a time: Feed() stops at the end of one, and
+ *        Take() hands it over and starts on the next.
+ * @throws JsonSyntaxError from Feed() or Finish() on invalid JSON, after
+ *         which the parser must be Reset() before it is fed again.
+ * @see   JsonPushBinder
+ */
+class JsonPushParser
+{
+public:
+  /**
+   * @brief Constructor that parses with the given settings.
+   * @param settings Depth limit, strictness and duplicate key handling.
+   */
+  explicit JsonPushParser(const JsonParserSettings& settings = JsonParserSettings());
+
+  JsonPushParser(const JsonPushParser&) = delete;
+  JsonPushParser& operator=(const JsonPushParser&) = delete;
+
+  /**
+   * @brief Parse the next bytes of the input.
+   * @param data Start of the bytes.
+   * @param size Number of bytes.
+   * @return Number of bytes read, fewer than size only if a document ended
+   *         before the rest.
+   */
+  size_t Feed(const char* data, size_t size);
+
+  /**
+   * @brief Parse the next bytes of the input.
+   * @param chunk The bytes.
+   * @return Number of bytes read, fewer than the chunk holds only if a
+   *         document ended before the rest.
+   */
+  inline size_t Feed(std::string_view chunk) { return Feed(chunk.data(), chunk.size()); }
+
+  /**
+   * @brief Signal the end of the input, which ends a number at the top level.
+   * @throws JsonSyntaxError if the input ends inside a document.
+   */
+  void Finish();
+
+  /**
+   * @brief Check whether a document has ended and is ready to Take().
+   * @return bool
+   */
+  inline bool Done() const { return _expect == Expect::End; }
+
+  /**
+   * @brief Check whether anything but whitespace has been read since the
+   *        last document was taken.
+   * @return bool
+   */
+  inline bool Started() const { return _started; }
+
+  /**
+   * @brief Take the document which has ended and start on the next.
+   * @return Json::Value
+   * @throws std::runtime_error if no document has ended.
+   */
+  Json::Value Take();
+
+  /**
+   * @brief Discard everything read, after an error for example, and start
+   *        again as if nothing had been fed.
+   */
+  void Reset();
+
+private:
+  /**
+   * @brief What may come next.
+   */
+  enum class Expect
+  {
+    Value,
+    FirstElement,  ///< A value or ']'.
+    FirstMember,   ///< A member name or '}'.
+    Member,
+    Colon,
+    Comma,         ///< A comma or the end of the current container.
+    End            ///< Nothing: the document has ended.
+  };
+
+  /**
+   * @brief Kind of the token being read.
+   */
+  enum class Token
+  {
+    None,
+    Name,
+    String,
+    Number,
+    Literal
+  };
+
+  static inline bool IsWhitespace(char c)
+  {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+  }
+
+  const char* Step(const char* position, const char* end);
+  const char* BeginValue(const char* position, const char* end);
+  const char* BeginToken(Token token, const char* position, const char* end);
+  const char* ReadToken(const char* position, const char* end);
+  void EndToken(const char* begin, const char* end);
+  void Open(bool object, const char* position);
+  void Close();
+  void EndValue();
+  Json::Value& Slot();
+  void Restart();
+
+  /**
+   * @brief Describe what is missing where something else, or the end of the
+   *        input, was found instead of a member name, colon or comma.
+   * @return const char*
+   */
+  const char* Missing() const;
+
+  // Column of a position in the current chunk, or of the end of the input
+  inline size_t Column(const char* position) const
+  {
+    return _offset + (position - _chunk) - _lineStart + 1;
+  }
+
+  [[noreturn]] void Error(const char* position, const std::string& message) const;
+
+  JsonParserSettings _settings;
+
+  // Settings for reading a single token, which is never a whole document
+  JsonParserSettings _tokenSettings;
+
+  Json::Value _root;
+
+  // Open containers, innermost last, and the name and value of the member
+  // being read
+  std::vector<Json::Value*> _stack;
+  std::string _name;
+  Json::Value* _member = nullptr;
+
+  Expect _expect = Expect::Value;
+  bool _started = false;
+
+  // Token being read: its start in the current chunk, or the bytes of it
+  // from earlier chunks, and where it started for errors
+  Token _token = Token::None;
+  const char* _tokenStart = nullptr;
+  std::string _partial;
+  size_t _tokenLine = 0;
+  size_t _tokenColumn = 0;
+
+  // Whether a string read so far ends in an unfinished escape
+  bool _escaped = false;
+
+  // Literal being read, and how much of it has been matched
+  const char* _literal = nullptr;
+  size_t _matched = 0;
+
+  // Bytes read before the current chunk, and the current line
+  const char* _chunk = nullptr;
+  size_t _offset = 0;
+  size_t _line = 1;
+  size_t _lineStart = 0;
+};
+
+/**
+ * @brief Binds T from JSON text fed in chunks as it arrives, parsing each
+ *        chunk with a JsonPushParser as soon as it is fed.
+ *        The input may hold documents one after another, a stream of
+ *        messages for example; each is bound as soon as it ends. Syntax
+ *        errors are reported in the result like validation errors, after
+ *        which the rest of the input is ignored until Reset().
+ * @see   JsonPushParser, Validate
+ */
+template<typename T>
+class JsonPushBinder
+{
+public:
+  /**
+   * @brief Constructor.
+   * @param mode Whether to stop at the first error in a document or collect all.
+   * @param parser Parser whose settings to read with, by default the calling
+   *        thread's parser.
+   */
+  explicit JsonPushBinder(ValidationMode mode = ValidationMode::FirstError,
+                          JsonParser& parser = JsonParser::ThreadLocal()) :
+    _parser(parser.GetSettings()),
+    _mode(mode)
+  {}
+
+  /**
+   * @brief Read the next bytes of the input, up to the end of a document.
+   * @param chunk Bytes to read, moved past those read. Call again while any
+   *        remain: they are the start of the next document.
+   * @return The bound document, or why it could not be bound, once one ends;
+   *         otherwise nothing.
+   */
+  std::optional<ValidationResult<T>> Feed(std::string_view& chunk)
+  {
+    if (_failed) {
+      chunk = std::string_view();
+      return std::nullopt;
+    }
+    try {
+      chunk.remove_prefix(_parser.Feed(chunk));
+      if (!_parser.Done()) {
+        return std::nullopt;
+      }
+      return Validate<T>(JsonData(_parser.Take()), _mode);
+    } catch (const JsonSyntaxError& e) {
+      chunk = std::string_view();
+      return Fail(e);
+    }
+  }
+
+  /**
+   * @brief Signal the end of the input.
+   * @return The last document if the input ended inside it, bound if only
+   *         the end could end it (a number at the top level) or an error if
+   *         it was cut short; otherwise nothing.
+   */
+  std::optional<ValidationResult<T>> Finish()
+  {
+    if (_failed || !_parser.Started()) {
+      return std::nullopt;
+    }
+    try {
+      _parser.Finish();
+      return Validate<T>(JsonData(_parser.Take()), _mode);
+    } catch (const JsonSyntaxError& e) {
+      return Fail(e);
+    }
+  }
+
+  /**
+   * @brief Discard everything read and start again as if nothing had been fed.
+   */
+  void Reset()
+  {
+    _parser.Reset();
+    _failed = false;
+  }
+
+private:
+  ValidationResult<T> Fail(const JsonSyntaxError& e)
+  {
+    // Where the next document starts is lost along with the syntax
+    _failed = true;
+    return ValidationResult<T>(ValidationErrors{ValidationError{e.what(), ""}});
+  }
+
+  JsonPushParser _parser;
+  ValidationMode _mode;
+  bool _failed = false;
+};
+
+#endif // JSON_PUSH_PARSER_H
@@ -0,0 +1,730 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <json/json.h>
+
+#include "JsonReader.h"
+#include "Utf8Validator.h"
+
+namespace
+{
+/**
+ * @brief Count the digits of a significand from its first non-zero digit,
+ *        skipping the decimal point.
+ * @return size_t (0 if every digit is zero)
+ */
+size_t SignificantDigits(const char* begin, const char* end)
+{
+  while (begin != end && (*begin == '0' || *begin == '.'))
+  {
+    begin++;
+  }
+  return (end - begin) - std::count(begin, end, '.');
+}
+}
+
+JsonReader::JsonReader(const char* begin, const char* end, const JsonParserSettings& settings,
+                       const JsonIndex* index) :
+  _begin(begin),
+  _position(begin),
+  _end(end),
+  _settings(settings),
+  _index(index),
+  _structural(index ? index->Positions() : nullptr),
+  _checkUtf8(settings.utf8 == Utf8Validation::PerString)
+{}
+
+JsonToken JsonReader::Peek()
+{
+  JsonToken token;
+  switch (Next())
+  {
+    case '{': token = JsonToken::Object; break;
+    case '[': token = JsonToken::Array; break;
+    case '"': token = JsonToken::String; break;
+    case 't': token = JsonToken::True; break;
+    case 'f': token = JsonToken::False; break;
+    case 'n': token = JsonToken::Null; break;
+    case '-': case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+      token = JsonToken::Number;
+      break;
+    default:
+      Error(_position == _end ? "Unexpected end of input, expected a value"
+                              : "Syntax error: value, object or array expected");
+  }
+
+  if (!_started)
+  {
+    _started = true;
+    if (_settings.strict && token != JsonToken::Object && token != JsonToken::Array)
+    {
+      Error("A valid JSON document must be either an array or an object value");
+    }
+  }
+  return token;
+}
+
+void JsonReader::Enter()
+{
+  if (++_depth > _settings.depthLimit)
+  {
+    Error("Exceeded stack limit");
+  }
+  _position++;
+  _first = true;
+}
+
+void JsonReader::BeginObject()
+{
+  if (Peek() != JsonToken::Object)
+  {
+    Error("Expected '{'");
+  }
+  Enter();
+}
+
+bool JsonReader::NextMember(std::string_view& name)
+{
+  // After a comma only a member name may follow, which rejects trailing commas
+  char c = Next();
+  if (c == '}')
+  {
+    _position++;
+    _depth--;
+    _first = false;
+    return false;
+  }
+
+  if (!_first)
+  {
+    if (c != ',')
+    {
+      Error("Missing ',' or '}' in object declaration");
+    }
+    _position++;
+    c = Next();
+  }
+  _first = false;
+
+  if (c != '"')
+  {
+    Error("Missing '}' or object member name");
+  }
+  name = ReadString();
+
+  if (Next() != ':')
+  {
+    Error("Missing ':' after object member name");
+  }
+  _position++;
+  return true;
+}
+
+void JsonReader::BeginArray()
+{
+  if (Peek() != JsonToken::Array)
+  {
+    Error("Expected '['");
+  }
+  Enter();
+}
+
+bool JsonReader::NextElement()
+{
+  char c = Next();
+  if (c == ']')
+  {
+    _position++;
+    _depth--;
+    _first = false;
+    return false;
+  }
+
+  if (!_first)
+  {
+    if (c != ',')
+    {
+      Error("Missing ',' or ']' in array declaration");
+    }
+    _position++;
+  }
+  _first = false;
+  return true;
+}
+
+std::string_view JsonReader::ReadString()
+{
+  if (Next() != '"')
+  {
+    Error("Expected string");
+  }
+
+  // Most strings have no escapes and are returned in place
+  const char* start = ++_position;
+  while (_position != _end)
+  {
+    unsigned char c = *_position;
+    if (c == '"')
+    {
+      return std::string_view(start, _position++ - start);
+    }
+    if (c == '\\')
+    {
+      return ReadEscapedString(start);
+    }
+    if (c < 0x20)
+    {
+      Error("Control character in string");
+    }
+    _position += c >= 0x80 && _checkUtf8 ? ReadUtf8Sequence() : 1;
+  }
+  Error("Missing '\"' at end of string");
+}
+
+std::string_view JsonReader::ReadEscapedString(const char* start)
+{
+  _scratch.assign(start, _position);
+  while (_position != _end)
+  {
+    unsigned char c = *_position++;
+    if (c == '"')
+    {
+      return _scratch;
+    }
+    if (c < 0x20)
+    {
+      _position--;
+      Error("Control character in string");
+    }
+    if (c >= 0x80 && _checkUtf8)
+    {
+      _position--;
+      size_t length = ReadUtf8Sequence();
+      _scratch.append(_position, length);
+      _position += length;
+      continue;
+    }
+    if (c != '\\')
+    {
+      _scratch.push_back(static_cast<char>(c));
+      continue;
+    }
+
+    if (_position == _end)
+    {
+      break;
+    }
+    switch (*_position++)
+    {
+      case '"': _scratch.push_back('"'); break;
+      case '\\': _scratch.push_back('\\'); break;
+      case '/': _scratch.push_back('/'); break;
+      case 'b': _scratch.push_back('\b'); break;
+      case 'f': _scratch.push_back('\f'); break;
+      case 'n': _scratch.push_back('\n'); break;
+      case 'r': _scratch.push_back('\r'); break;
+      case 't': _scratch.push_back('\t'); break;
+      case 'u':
+      {
+        uint32_t codePoint = ReadHex4();
+        if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+        {
+          // A high surrogate must be followed by a low one
+          if (_end - _position < 6 || _position[0] != '\\' || _position[1] != 'u')
+          {
+            Error("Expecting another \\u token to begin the second half of a unicode surrogate pair");
+          }
+          _position += 2;
+          uint32_t low = ReadHex4();
+          if (low < 0xDC00 || low > 0xDFFF)
+          {
+            Error("Expecting a low surrogate in the second half of a unicode surrogate pair");
+          }
+          codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+        }
+        else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF)
+        {
+          Error("Unpaired low surrogate in string");
+        }
+        AppendCodePoint(codePoint);
+        break;
+      }
+      default:
+        _position--;
+        Error("Bad escape sequence in string");
+    }
+  }
+  Error("Missing '\"' at end of string");
+}
+
+size_t JsonReader::ReadUtf8Sequence()
+{
+  size_t length = Utf8Validator::SequenceLength(_position, _end);
+  if (length == 0)
+  {
+    Error("Invalid UTF-8 in string");
+  }
+  return length;
+}
+
+uint32_t JsonReader::ReadHex4()
+{
+  if (_end - _position < 4)
+  {
+    Error("Bad unicode escape sequence in string: four digits expected");
+  }
+  uint32_t value = 0;
+  for (int i = 0; i < 4; i++)
+  {
+    char c = *_position++;
+    value <<= 4;
+    if (c >= '0' && c <= '9')
+    {
+      value |= c - '0';
+    }
+    else if (c >= 'a' && c <= 'f')
+    {
+      value |= c - 'a' + 10;
+    }
+    else if (c >= 'A' && c <= 'F')
+    {
+      value |= c - 'A' + 10;
+    }
+    else
+    {
+      Error("Bad unicode escape sequence in string: hexadecimal digit expected");
+    }
+  }
+  return value;
+}
+
+void JsonReader::AppendCodePoint(uint32_t codePoint)
+{
+  if (codePoint < 0x80)
+  {
+    _scratch.push_back(static_cast<char>(codePoint));
+  }
+  else if (codePoint < 0x800)
+  {
+    _scratch.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+    _scratch.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+  }
+  else if (codePoint < 0x10000)
+  {
+    _scratch.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+    _scratch.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+    _scratch.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+  }
+  else
+  {
+    _scratch.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+    _scratch.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+    _scratch.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+    _scratch.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+  }
+}
+
+JsonNumber JsonReader::ReadNumber()
+{
+  if (Peek() != JsonToken::Number)
+  {
+    Error("Expected number");
+  }
+
+  JsonNumber number;
+  const char* start = _position;
+  if (*_position == '-')
+  {
+    number.negative = true;
+    _position++;
+  }
+
+  // Integer part: a single zero or digits not starting with zero
+  const char* digits = _position;
+  bool overflow = false;
+  ReadDigits(number.magnitude, overflow);
+  if (_position == digits || (*digits == '0' && _position - digits > 1))
+  {
+    Error("Bad number: digits expected");
+  }
+
+  // Fraction digits carry on into the same significand
+  bool real = false;
+  int64_t exponent = 0;
+  if (_position != _end && *_position == '.')
+  {
+    real = true;
+    const char* fraction = ++_position;
+    ReadDigits(number.magnitude, overflow);
+    if (_position == fraction)
+    {
+      Error("Bad number: digits expected after '.'");
+    }
+    exponent = fraction - _position;
+  }
+  const char* significand = _position;
+  if (_position != _end && (*_position == 'e' || *_position == 'E'))
+  {
+    real = true;
+    _position++;
+    bool negativeExponent = false;
+    if (_position != _end && (*_position == '+' || *_position == '-'))
+    {
+      negativeExponent = *_position++ == '-';
+    }
+    const char* exponentDigits = _position;
+    int64_t written = 0;
+    while (_position != _end && *_position >= '0' && *_position <= '9')
+    {
+      // Anything this large is out of range, or zero, either way
+      written = written < 100000 ? written * 10 + (*_position - '0') : written;
+      _position++;
+    }
+    if (_position == exponentDigits)
+    {
+      Error("Bad number: digits expected in exponent");
+    }
+    exponent += negativeExponent ? -written : written;
+  }
+
+  // Like jsoncpp, an integer too large for 64 bits is kept as a double
+  if (!real && !overflow && (!number.negative || number.magnitude <= (uint64_t(1) << 63)))
+  {
+    number.integer = true;
+    number.real = number.negative ? -static_cast<double>(number.magnitude)
+                                  : static_cast<double>(number.magnitude);
+    return number;
+  }
+
+  // Clinger's fast path: a significand and a power of ten which are both
+  // exact doubles give a correctly rounded product or quotient
+  static constexpr double kPowersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  if (!overflow && number.magnitude <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+  {
+    double value = static_cast<double>(number.magnitude);
+    value = exponent < 0 ? value / kPowersOfTen[-exponent] : value * kPowersOfTen[exponent];
+    number.real = number.negative ? -value : value;
+  }
+  else
+  {
+    // Everything else is left to from_chars, which is exact
+    auto [end, error] = std::from_chars(start, _position, number.real);
+    if (error == std::errc::result_out_of_range && end == _position &&
+        exponent + static_cast<int64_t>(SignificantDigits(digits, significand)) <= 0)
+    {
+      // Too small for a double rather than too large: zero, as jsoncpp reads it
+      number.real = number.negative ? -0.0 : 0.0;
+    }
+    else if (error != std::errc() || end != _position)
+    {
+      Error("Bad number: '" + std::string(start, _position) + "' is out of range");
+    }
+  }
+  number.negative = false;
+  number.magnitude = 0;
+  return number;
+}
+
+void JsonReader::ReadDigits(uint64_t& value, bool& overflow)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  // Eight digits at a time while there are that many
+  while (_end - _position >= 8)
+  {
+    uint64_t chunk;
+    std::memcpy(&chunk, _position, 8);
+    if (((chunk & 0xF0F0F0F0F0F0F0F0ull) |
+         (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) != 0x3333333333333333ull)
+    {
+      break;
+    }
+    // Combine neighbouring digits, then pairs of those, then pairs of those
+    chunk -= 0x3030303030303030ull;
+    chunk = chunk * 10 + (chunk >> 8);
+    chunk = ((chunk & 0x000000FF000000FFull) * (100 + (1000000ull << 32)) +
+             ((chunk >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32))) >> 32;
+    overflow |= __builtin_mul_overflow(value, 100000000, &value) ||
+                __builtin_add_overflow(value, chunk, &value);
+    _position += 8;
+  }
+#endif
+  while (_position != _end && *_position >= '0' && *_position <= '9')
+  {
+    uint64_t digit = *_position++ - '0';
+    overflow |= __builtin_mul_overflow(value, 10, &value) ||
+                __builtin_add_overflow(value, digit, &value);
+  }
+}
+
+void JsonReader::ReadLiteral(const char* literal, size_t length)
+{
+  if (static_cast<size_t>(_end - _position) < length || std::memcmp(_position, literal, length) != 0)
+  {
+    Error("Syntax error: value, object or array expected");
+  }
+  _position += length;
+}
+
+bool JsonReader::ReadBool()
+{
+  switch (Peek())
+  {
+    case JsonToken::True:
+      ReadLiteral("true", 4);
+      return true;
+    case JsonToken::False:
+      ReadLiteral("false", 5);
+      return false;
+    default:
+      Error("Expected boolean");
+  }
+}
+
+void JsonReader::ReadNull()
+{
+  if (Peek() != JsonToken::Null)
+  {
+    Error("Expected null");
+  }
+  ReadLiteral("null", 4);
+}
+
+void JsonReader::Skip()
+{
+  JsonToken token = Peek();
+  if (_settings.onDemand && (token == JsonToken::Object || token == JsonToken::Array))
+  {
+    SkipContainer();
+    return;
+  }
+
+  switch (token)
+  {
+    case JsonToken::Object:
+    {
+      std::string_view name;
+      BeginObject();
+      while (NextMember(name))
+      {
+        Skip();
+      }
+      break;
+    }
+    case JsonToken::Array:
+      BeginArray();
+      while (NextElement())
+      {
+        Skip();
+      }
+      break;
+    case JsonToken::String:
+      ReadString();
+      break;
+    case JsonToken::Number:
+      ReadNumber();
+      break;
+    case JsonToken::True:
+    case JsonToken::False:
+      ReadBool();
+      break;
+    case JsonToken::Null:
+      ReadNull();
+      break;
+  }
+}
+
+void JsonReader::SkipUnchecked()
+{
+  JsonToken token = Peek();
+  if (token == JsonToken::Object || token == JsonToken::Array)
+  {
+    SkipContainer();
+    return;
+  }
+  Skip();
+}
+
+void JsonReader::SkipContainer()
+{
+  // Count brackets until the one which closes the container
+  unsigned depth = 0;
+  if (_structural)
+  {
+    // Brackets outside strings are all in the index
+    size_t offset = _position - _begin;
+    while (*_structural < offset)
+    {
+      _structural++;
+    }
+    for (const uint32_t* end = _index->Positions() + _index->Size(); _structural != end; _structural++)
+    {
+      char c = _begin[*_structural];
+      if (c == '{' || c == '[')
+      {
+        depth++;
+      }
+      else if ((c == '}' || c == ']') && --depth == 0)
+      {
+        _position = _begin + *_structural++ + 1;
+        return;
+      }
+    }
+    _position = _end;
+  }
+  else
+  {
+    while (_position != _end)
+    {
+      char c = *_position++;
+      if (c == '"')
+      {
+        // Find the closing quote: one not escaped by an odd run of backslashes
+        const char* quote;
+        while ((quote = static_cast<const char*>(std::memchr(_position, '"', _end - _position))))
+        {
+          const char* backslash = quote;
+          while (backslash != _position && backslash[-1] == '\\')
+          {
+            backslash--;
+          }
+          _position = quote + 1;
+          if ((quote - backslash) % 2 == 0)
+          {
+            break;
+          }
+        }
+        if (!quote)
+        {
+          _position = _end;
+        }
+      }
+      else if (c == '{' || c == '[')
+      {
+        depth++;
+      }
+      else if ((c == '}' || c == ']') && --depth == 0)
+      {
+        return;
+      }
+    }
+  }
+  Error("Missing '}' or ']' at end of input");
+}
+
+void JsonReader::Seek(const char* position)
+{
+  _position = position;
+  if (_index)
+  {
+    _structural = std::lower_bound(_index->Positions(), _index->Positions() + _index->Size(),
+                                   static_cast<uint32_t>(position - _begin));
+  }
+}
+
+void JsonReader::ReadValue(Json::Value& value)
+{
+  switch (Peek())
+  {
+    case JsonToken::Object:
+      ReadObject(value);
+      break;
+    case JsonToken::Array:
+      ReadArray(value);
+      break;
+    case JsonToken::String:
+    {
+      std::string_view string = ReadString();
+      value = Json::Value(string.data(), string.data() + string.size());
+      break;
+    }
+    case JsonToken::Number:
+    {
+      JsonNumber number = ReadNumber();
+      if (!number.integer)
+      {
+        value = number.real;
+      }
+      else if (number.negative)
+      {
+        value = static_cast<Json::Int64>(0 - number.magnitude);
+      }
+      else if (number.magnitude <= static_cast<uint64_t>(Json::Value::maxInt64))
+      {
+        value = static_cast<Json::Int64>(number.magnitude);
+      }
+      else
+      {
+        value = static_cast<Json::UInt64>(number.magnitude);
+      }
+      break;
+    }
+    case JsonToken::True:
+    case JsonToken::False:
+      value = ReadBool();
+      break;
+    case JsonToken::Null:
+      ReadNull();
+      value = Json::Value();
+      break;
+  }
+}
+
+void JsonReader::ReadObject(Json::Value& value)
+{
+  value = Json::Value(Json::objectValue);
+  std::string_view name;
+  BeginObject();
+  while (NextMember(name))
+  {
+    if (_settings.rejectDuplicateKeys && value.find(name.data(), name.data() + name.size()))
+    {
+      Error("Duplicate key: '" + std::string(name) + "'");
+    }
+    // demand() copies the name before the value is read over the scratch buffer
+    ReadValue(*value.demand(name.data(), name.data() + name.size()));
+  }
+}
+
+void JsonReader::ReadArray(Json::Value& value)
+{
+  value = Json::Value(Json::arrayValue);
+  BeginArray();
+  while (NextElement())
+  {
+    ReadValue(value.append(Json::Value()));
+  }
+}
+
+void JsonReader::Finish()
+{
+  if (Next() != 0 || _position != _end)
+  {
+    Error("Extra non-whitespace after JSON value");
+  }
+}
+
+void JsonReader::Error(const std::string& message) const
+{
+  throw JsonSyntaxError::At(_begin, _position, message);
+}
+
+JsonSyntaxError JsonSyntaxError::At(const char* begin, const char* position, const std::string& message)
+{
+  // Work out the line and column only once there is an error to report
+  size_t line = 1;
+  const char* lineStart = begin;
+  for (const char* c = begin; c < position; c++)
+  {
+    if (*c == '\n')
+    {
+      line++;
+      lineStart = c + 1;
+    }
+  }
+  return JsonSyntaxError(line, position - lineStart + 1, message);
+}
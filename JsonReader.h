@@ -0,0 +1,321 @@
+#ifndef JSON_READER_H
+#define JSON_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <json/json.h>
+
+#include "JsonIndex.h"
+#include "JsonParser.h"
+
+/**
+ * @brief Syntax error in JSON text, thrown by JsonReader.
+ *        Kept apart from validation errors: binding never carries on past a
+ *        syntax error, whichever ValidationMode is in use.
+ */
+class JsonSyntaxError : public std::runtime_error
+{
+public:
+  /**
+   * @brief Constructor that describes the error.
+   * @param details Position and description of the error.
+   */
+  explicit JsonSyntaxError(const std::string& details) :
+    std::runtime_error("JSON parsing error: " + details),
+    _details(details),
+    _message(details)
+  {}
+
+  /**
+   * @brief Constructor for an error at a line and column of JSON text.
+   * @param line Line of the error, counting from 1.
+   * @param column Column of the error, counting from 1.
+   * @param message Description of the error.
+   */
+  JsonSyntaxError(size_t line, size_t column, const std::string& message) :
+    JsonSyntaxError("* Line " + std::to_string(line) + ", Column " + std::to_string(column) +
+                    "\n  " + message + "\n")
+  {
+    _line = line;
+    _column = column;
+    _message = message;
+  }
+
+  /**
+   * @brief Get the position and description of the error, as reported by
+   *        JsonParser::Parse().
+   * @return const std::string&
+   */
+  inline const std::string& Details() const { return _details; }
+
+  /**
+   * @brief Get the description of the error without its position.
+   * @return const std::string&
+   */
+  inline const std::string& Message() const { return _message; }
+
+  /**
+   * @brief Get the line of the error, counting from 1.
+   * @return size_t (0 if the error has no position)
+   */
+  inline size_t Line() const { return _line; }
+
+  /**
+   * @brief Get the column of the error, counting from 1.
+   * @return size_t (0 if the error has no position)
+   */
+  inline size_t Column() const { return _column; }
+
+  /**
+   * @brief Create an error at a position in JSON text, working out its line
+   *        and column.
+   * @param begin Start of the JSON text.
+   * @param position Position of the error.
+   * @param message Description of the error.
+   * @return JsonSyntaxError
+   */
+  static JsonSyntaxError At(const char* begin, const char* position, const std::string& message);
+
+private:
+  std::string _details;
+  std::string _message;
+  size_t _line = 0;
+  size_t _column = 0;
+};
+
+/**
+ * @brief Kind of a JSON value, as seen from its first character.
+ */
+enum class JsonToken
+{
+  Object,
+  Array,
+  String,
+  Number,
+  True,
+  False,
+  Null
+};
+
+/**
+ * @brief Number read from JSON text. Integers which fit in 64 bits are kept
+ *        exactly; anything else is a double.
+ */
+struct JsonNumber
+{
+  bool integer = false;   ///< No fraction or exponent and fits in 64 bits.
+  bool negative = false;  ///< Sign of an integer.
+  uint64_t magnitude = 0; ///< Absolute value of an integer.
+  double real = 0;        ///< Value as a double, set for every number.
+};
+
+/**
+ * @brief Pull reader over JSON text, which hands out one value at a time.
+ *        The text is read in a single pass without building a tree, which
+ *        lets a caller write values straight to where they are wanted, or
+ *        build a Json::Value with ReadValue().
+ *        Objects are read with BeginObject() and NextMember() until it
+ *        returns false, arrays with BeginArray() and NextElement(); each
+ *        member or element must be read or skipped before the next.
+ *        The text is parsed as RFC 8259 JSON: comments and trailing commas
+ *        are rejected whatever the settings. Strings are checked to be valid
+ *        UTF-8 only with Utf8Validation::PerString.
+ * @throws JsonSyntaxError from any read which meets invalid JSON.
+ */
+class JsonReader
+{
+public:
+  /**
+   * @brief Constructor that reads the given text, which must outlive the reader.
+   * @param begin Start of the JSON text.
+   * @param end End of the JSON text.
+   * @param settings Depth limit, strictness and duplicate key handling.
+   * @param index Structural index of the text, which lets whitespace be
+   *        jumped over; must outlive the reader. Optional.
+   */
+  JsonReader(const char* begin, const char* end,
+             const JsonParserSettings& settings = JsonParserSettings(),
+             const JsonIndex* index = nullptr);
+
+  /**
+   * @brief Get the kind of the next value without reading it.
+   * @return JsonToken
+   */
+  JsonToken Peek();
+
+  /**
+   * @brief Read the opening brace of an object.
+   */
+  void BeginObject();
+
+  /**
+   * @brief Read the name of the next member of the current object.
+   * @param name Set to the member name; valid until the next string is read.
+   * @return false, having read the closing brace, if there are no more members.
+   */
+  bool NextMember(std::string_view& name);
+
+  /**
+   * @brief Read the opening bracket of an array.
+   */
+  void BeginArray();
+
+  /**
+   * @brief Move to the next element of the current array.
+   * @return false, having read the closing bracket, if there are no more elements.
+   */
+  bool NextElement();
+
+  /**
+   * @brief Read a string.
+   * @return The unescaped string; valid until the next string is read.
+   */
+  std::string_view ReadString();
+
+  /**
+   * @brief Read a number. One too small for a double reads as a zero of
+   *        the same sign, as jsoncpp reads it; one too large is an error.
+   * @return JsonNumber
+   */
+  JsonNumber ReadNumber();
+
+  /**
+   * @brief Read true or false.
+   * @return bool
+   */
+  bool ReadBool();
+
+  /**
+   * @brief Read null.
+   */
+  void ReadNull();
+
+  /**
+   * @brief Read and discard the next value, checking its syntax. With the
+   *        onDemand setting an object or array is skipped by matching its
+   *        brackets instead, without checking anything in between.
+   */
+  void Skip();
+
+  /**
+   * @brief Move past the next value without checking what is inside it, for
+   *        a value which will be read with Seek() later, which checks it.
+   *        An object or array is skipped by matching its brackets.
+   */
+  void SkipUnchecked();
+
+  /**
+   * @brief Get the position of the next value, to come back to with Seek().
+   * @return const char*
+   */
+  inline const char* Position()
+  {
+    Next();
+    return _position;
+  }
+
+  /**
+   * @brief Move to a value whose position was taken with Position(), to read
+   *        it again or out of order. The value is read at the depth the
+   *        reader is at.
+   * @param position Position of the value.
+   */
+  void Seek(const char* position);
+
+  /**
+   * @brief Read the next value into a Json::Value.
+   * @param value Value to store the result in.
+   */
+  void ReadValue(Json::Value& value);
+
+  /**
+   * @brief Check that nothing but whitespace follows the document.
+   */
+  void Finish();
+
+  /**
+   * @brief Exchange the buffer strings are unescaped into with another
+   *        string, to hand its capacity from one reader to the next.
+   * @param scratch String to exchange with.
+   */
+  inline void SwapScratch(std::string& scratch) { _scratch.swap(scratch); }
+
+  /**
+   * @brief Get the settings the reader was created with.
+   * @return const JsonParserSettings&
+   */
+  inline const JsonParserSettings& GetSettings() const { return _settings; }
+
+  /**
+   * @brief Throw a syntax error at the current position.
+   * @param message Description of the error.
+   * @throws JsonSyntaxError
+   */
+  [[noreturn]] void Error(const std::string& message) const;
+
+private:
+  /**
+   * @brief Skip whitespace and get the next character.
+   * @return The character, or 0 at the end of the text.
+   */
+  inline char Next()
+  {
+    if (_structural && _position != _end && IsWhitespace(*_position)) {
+      // The next token starts at the next structural position
+      size_t offset = _position - _begin;
+      while (*_structural < offset) {
+        _structural++;
+      }
+      _position = _begin + *_structural;
+    }
+    while (_position != _end && IsWhitespace(*_position)) {
+      _position++;
+    }
+    return _position != _end ? *_position : 0;
+  }
+
+  static inline bool IsWhitespace(char c)
+  {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+  }
+
+  void Enter();
+  void ReadLiteral(const char* literal, size_t length);
+  void SkipContainer();
+  void ReadDigits(uint64_t& value, bool& overflow);
+  void ReadObject(Json::Value& value);
+  void ReadArray(Json::Value& value);
+  std::string_view ReadEscapedString(const char* start);
+  size_t ReadUtf8Sequence();
+  void AppendCodePoint(uint32_t codePoint);
+  uint32_t ReadHex4();
+
+  const char* _begin;
+  const char* _position;
+  const char* _end;
+  JsonParserSettings _settings;
+
+  // Next structural position not yet passed, when reading with an index
+  const JsonIndex* _index;
+  const uint32_t* _structural = nullptr;
+
+  // Nesting depth of the containers being read
+  unsigned _depth = 0;
+
+  // Set by BeginObject()/BeginArray() until the first member or element
+  bool _first = false;
+
+  // Whether the document has started, for the strict root check
+  bool _started = false;
+
+  // Whether strings are checked to be valid UTF-8 as they are read
+  bool _checkUtf8;
+
+  // Unescaped strings, reused between reads
+  std::string _scratch;
+};
+
+#endif // JSON_READER_H
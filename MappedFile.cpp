@@ -0,0 +1,97 @@
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MappedFile.h"
+
+MappedFile::MappedFile(const std::string& path)
+{
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    throw std::runtime_error("Could not open JSON file: " + path);
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+  {
+    void* address = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address != MAP_FAILED)
+    {
+      madvise(address, info.st_size, MADV_SEQUENTIAL);
+      _data = static_cast<const char*>(address);
+      _size = info.st_size;
+      _mapped = true;
+      close(fd);
+      return;
+    }
+  }
+
+  // Not a regular file, or mapping failed: read until end of file
+  constexpr size_t kChunk = 64 * 1024;
+  for (;;)
+  {
+    size_t used = _buffer.size();
+    _buffer.resize(used + kChunk);
+    ssize_t count = read(fd, _buffer.data() + used, kChunk);
+    if (count < 0 && errno == EINTR)
+    {
+      _buffer.resize(used);
+      continue;
+    }
+    if (count < 0)
+    {
+      close(fd);
+      throw std::runtime_error("Could not read JSON file: " + path);
+    }
+    _buffer.resize(used + count);
+    if (count == 0)
+    {
+      break;
+    }
+  }
+  close(fd);
+
+  _data = _buffer.data();
+  _size = _buffer.size();
+}
+
+MappedFile::~MappedFile()
+{
+  Unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+  _data(std::exchange(other._data, nullptr)),
+  _size(std::exchange(other._size, 0)),
+  _mapped(std::exchange(other._mapped, false)),
+  _buffer(std::move(other._buffer))
+{}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+  if (this != &other)
+  {
+    Unmap();
+    _data = std::exchange(other._data, nullptr);
+    _size = std::exchange(other._size, 0);
+    _mapped = std::exchange(other._mapped, false);
+    _buffer = std::move(other._buffer);
+  }
+  return *this;
+}
+
+void MappedFile::Unmap()
+{
+  if (_mapped)
+  {
+    munmap(const_cast<char*>(_data), _size);
+    _mapped = false;
+  }
+}
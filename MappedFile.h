@@ -0,0 +1,58 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Read-only view of the contents of a file.
+ *        Regular files are memory mapped with a sequential access hint.
+ *        Pipes and special files, which cannot be mapped, are read into a
+ *        buffer with read().
+ */
+class MappedFile
+{
+public:
+  /**
+   * @brief Constructor that maps or reads a file.
+   * @param path Path to the file.
+   * @throws std::runtime_error if the file cannot be opened or read.
+   */
+  explicit MappedFile(const std::string& path);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  /**
+   * @brief Get the contents of the file.
+   * @return const char* (not null-terminated)
+   */
+  inline const char* Data() const { return _data; }
+
+  /**
+   * @brief Get the size of the file contents.
+   * @return size_t
+   */
+  inline size_t Size() const { return _size; }
+
+  /**
+   * @brief Whether the contents are memory mapped rather than read.
+   * @return bool
+   */
+  inline bool IsMapped() const { return _mapped; }
+
+private:
+  void Unmap();
+
+  const char* _data = nullptr;
+  size_t _size = 0;
+  bool _mapped = false;
+  std::vector<char> _buffer;
+};
+
+#endif // MAPPED_FILE_H
@@ -9,11 +9,16 @@ public:
   MyData2(JsonData&& data) :
     ValidatedJson(std::move(data))
   {
-    Required("age", _age);
+    Bind(*this);
   }
 
   MyData2() {}
 
+  static constexpr auto Fields()
+  {
+    return FieldList(Required("age", &MyData2::_age));
+  }
+
   std::string ToString() const
   {
     std::stringstream ss;
@@ -31,10 +36,15 @@ public:
   MyData(JsonData&& data) :
     ValidatedJson(std::move(data))
   {
-    Optional("name", _name, "No name provided");
-    Required("description", _description);
-    Required("nested", _nestedData);
-    Required("values", _values);
+    Bind(*this);
+  }
+
+  static constexpr auto Fields()
+  {
+    return FieldList(Optional("name", &MyData::_name, "No name provided"),
+                     Required("description", &MyData::_description),
+                     Required("nested", &MyData::_nestedData),
+                     Required("values", &MyData::_values));
   }
 
   std::string ToString() const
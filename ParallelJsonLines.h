@@ -0,0 +1,192 @@
+#ifndef PARALLEL_JSON_LINES_H
+#define PARALLEL_JSON_LINES_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "JsonLinesFile.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include "ValidatedJson.h"
+
+/**
+ * @brief Order in which ParallelJsonLines hands over records.
+ */
+enum class LineOrder
+{
+  Ordered,   ///< In the order of the file.
+  Unordered  ///< As soon as they are bound, a chunk at a time.
+};
+
+/**
+ * @brief Reader of newline-delimited JSON (JSON Lines, NDJSON) which binds
+ *        the lines of a file to T on every thread of a ThreadPool.
+ *        The file is split at newlines into chunks, each of which is bound
+ *        on a worker thread line by line as by JsonLinesFile, reading with
+ *        one copy of the parser's settings shared by every thread. Records
+ *        are handed to a callback on the calling thread, in file order or as
+ *        soon as their chunk is done. Only a few chunks per thread are in
+ *        flight at once, so the records held in memory don't grow with the
+ *        file. The calling thread binds chunks too while it waits, so it may
+ *        be a worker of the same pool.
+ * @see   JsonLinesFile, ThreadPool
+ */
+template<typename T>
+class ParallelJsonLines
+{
+public:
+  /**
+   * @brief Constructor that opens a file.
+   * @param path Path to the file.
+   * @param pool Threads to bind on; must outlive the reader.
+   * @param order Whether records are handed over in file order.
+   * @param mode Whether to stop at the first error in a line or collect all.
+   * @param parser Parser whose settings to read with, by default the calling
+   *        thread's parser.
+   * @param chunkSize Number of bytes of the file to bind in one task.
+   * @throws std::runtime_error if the file cannot be opened or read.
+   */
+  ParallelJsonLines(const std::string& path, ThreadPool& pool, LineOrder order = LineOrder::Ordered,
+                    ValidationMode mode = ValidationMode::FirstError,
+                    JsonParser& parser = JsonParser::ThreadLocal(), size_t chunkSize = 1 << 20) :
+    _file(path),
+    _pool(pool),
+    _order(order),
+    _mode(mode),
+    _settings(parser.GetSettings()),
+    _chunkSize(std::max<size_t>(chunkSize, 1))
+  {}
+
+  /**
+   * @brief Bind every line of the file, skipping blank lines.
+   * @param callback Called on the calling thread with each JsonLine<T>&&.
+   * @throws Whatever the callback throws, once the chunks in flight are done.
+   */
+  template<typename F>
+  void ForEach(F&& callback)
+  {
+    State state;
+    const char* next = _file.Data();
+    const char* end = next + _file.Size();
+    size_t number = 1;
+    size_t submitted = 0;
+    size_t delivered = 0;
+    const size_t window = 4 * static_cast<size_t>(_pool.Size());
+
+    try {
+      while (next != end || delivered != submitted) {
+        // Split off chunks while there is room in the window; counting
+        // their lines here gives every chunk its first line number up front
+        while (next != end && submitted - delivered < window) {
+          const char* stop = end;
+          if (static_cast<size_t>(end - next) > _chunkSize) {
+            const void* newline = std::memchr(next + _chunkSize, '\n', end - next - _chunkSize);
+            stop = newline ? static_cast<const char*>(newline) + 1 : end;
+          }
+          Submit(state, submitted++, next, stop, number);
+          number += std::count(next, stop, '\n');
+          next = stop;
+        }
+
+        Chunk chunk;
+        {
+          std::unique_lock<std::mutex> lock(state.mutex);
+          _pool.Wait(lock, state.ready, [&] {
+            return !state.done.empty() &&
+                   (_order == LineOrder::Unordered || state.done.begin()->first == delivered);
+          });
+          chunk = std::move(state.done.begin()->second);
+          state.done.erase(state.done.begin());
+        }
+        delivered++;
+
+        if (chunk.error) {
+          std::rethrow_exception(chunk.error);
+        }
+        for (JsonLine<T>& line : chunk.lines) {
+          callback(std::move(line));
+        }
+      }
+    } catch (...) {
+      // The tasks still running refer to the state
+      std::unique_lock<std::mutex> lock(state.mutex);
+      _pool.Wait(lock, state.ready, [&] { return state.finished == submitted; });
+      throw;
+    }
+  }
+
+private:
+  /**
+   * @brief Records of one chunk, or what stopped it being bound.
+   */
+  struct Chunk
+  {
+    std::vector<JsonLine<T>> lines;
+    std::exception_ptr error;
+  };
+
+  /**
+   * @brief Chunks done by the workers and not yet handed over, by index.
+   */
+  struct State
+  {
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::map<size_t, Chunk> done;
+    size_t finished = 0;
+  };
+
+  void Submit(State& state, size_t index, const char* begin, const char* end, size_t number)
+  {
+    _pool.Submit([this, &state, index, begin, end, number] {
+      Chunk chunk;
+      try {
+        chunk.lines = BindChunk(begin, end, number);
+      } catch (...) {
+        chunk.error = std::current_exception();
+      }
+      // Notified under the lock, as the state may be gone once it is released
+      std::lock_guard<std::mutex> lock(state.mutex);
+      state.done.emplace(index, std::move(chunk));
+      state.finished++;
+      state.ready.notify_all();
+    });
+  }
+
+  std::vector<JsonLine<T>> BindChunk(const char* begin, const char* end, size_t number) const
+  {
+    std::vector<JsonLine<T>> lines;
+    // Chunks are bound on any worker, so each has buffers of its own
+    JsonTextBuffers buffers;
+    for (; begin != end; number++) {
+      const char* newline = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+      const char* stop = newline ? newline : end;
+      if (stop != begin && stop[-1] == '\r') {
+        stop--;
+      }
+      std::string_view line(begin, stop - begin);
+      if (line.find_first_not_of(" \t\r") != std::string_view::npos) {
+        lines.push_back(JsonLine<T>{number, ValidateText<T>(line, _mode, _settings, buffers)});
+      }
+      begin = newline ? newline + 1 : end;
+    }
+    return lines;
+  }
+
+  MappedFile _file;
+  ThreadPool& _pool;
+  LineOrder _order;
+  ValidationMode _mode;
+  JsonParserSettings _settings;
+  size_t _chunkSize;
+};
+
+#endif // PARALLEL_JSON_LINES_H
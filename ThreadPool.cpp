@@ -0,0 +1,192 @@
+#include <exception>
+#include <utility>
+
+#include "ThreadPool.h"
+
+namespace
+{
+// Pool and index of the calling thread, when it is a worker
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local unsigned currentIndex = 0;
+}
+
+ThreadPool::ThreadPool(unsigned threads)
+{
+  if (threads == 0)
+  {
+    threads = std::thread::hardware_concurrency();
+  }
+  if (threads == 0)
+  {
+    threads = 1;
+  }
+
+  for (unsigned i = 0; i < threads; i++)
+  {
+    _queues.push_back(std::make_unique<Queue>());
+  }
+  _threads.reserve(threads);
+  for (unsigned i = 0; i < threads; i++)
+  {
+    _threads.emplace_back(&ThreadPool::Work, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopping = true;
+  }
+  _wake.notify_all();
+  for (std::thread& thread : _threads)
+  {
+    thread.join();
+  }
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+  unsigned worker = WorkerIndex();
+  Queue& queue = *_queues[worker < Size() ? worker : _next++ % _queues.size()];
+  // Counted before it can be taken, so taking it never drops the count
+  // below zero; a worker which wakes in between only looks again
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pending++;
+  }
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  _wake.notify_one();
+}
+
+void ThreadPool::Run(size_t count, const std::function<void(size_t)>& body)
+{
+  struct Latch
+  {
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t remaining;
+    std::exception_ptr error;
+  };
+  Latch latch;
+  latch.remaining = count;
+
+  for (size_t i = 0; i < count; i++)
+  {
+    Submit([&latch, &body, i]
+    {
+      std::exception_ptr error;
+      try
+      {
+        body(i);
+      }
+      catch (...)
+      {
+        error = std::current_exception();
+      }
+      // Notified under the lock, as the latch may be gone once it is released
+      std::lock_guard<std::mutex> lock(latch.mutex);
+      if (error && !latch.error)
+      {
+        latch.error = error;
+      }
+      if (--latch.remaining == 0)
+      {
+        latch.done.notify_all();
+      }
+    });
+  }
+
+  std::unique_lock<std::mutex> lock(latch.mutex);
+  Wait(lock, latch.done, [&latch] { return latch.remaining == 0; });
+  if (latch.error)
+  {
+    std::rethrow_exception(latch.error);
+  }
+}
+
+void ThreadPool::Wait(std::unique_lock<std::mutex>& lock, std::condition_variable& ready,
+                      const std::function<bool()>& done)
+{
+  // Help rather than only wait; once the queues are empty every task left
+  // is running on some thread
+  while (!done())
+  {
+    lock.unlock();
+    bool ran = RunOne();
+    lock.lock();
+    if (!ran)
+    {
+      ready.wait(lock, done);
+      return;
+    }
+  }
+}
+
+unsigned ThreadPool::WorkerIndex() const
+{
+  return currentPool == this ? currentIndex : Size();
+}
+
+ThreadPool& ThreadPool::Shared()
+{
+  static ThreadPool pool;
+  return pool;
+}
+
+void ThreadPool::Work(unsigned index)
+{
+  currentPool = this;
+  currentIndex = index;
+  for (;;)
+  {
+    if (RunOne())
+    {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(_mutex);
+    _wake.wait(lock, [this] { return _stopping || _pending > 0; });
+    if (_stopping && _pending == 0)
+    {
+      return;
+    }
+  }
+}
+
+bool ThreadPool::RunOne()
+{
+  // Start with the calling worker's own queue, newest task first while its
+  // data is likely still in cache, then steal the oldest from the others
+  unsigned worker = WorkerIndex();
+  size_t start = worker < Size() ? worker : 0;
+  for (size_t i = 0; i < _queues.size(); i++)
+  {
+    Queue& queue = *_queues[(start + i) % _queues.size()];
+    bool own = i == 0 && worker < Size();
+    std::function<void()> task;
+    {
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.tasks.empty())
+      {
+        continue;
+      }
+      if (own)
+      {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+      }
+      else
+      {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+      }
+    }
+    _pending--;
+    task();
+    return true;
+  }
+  return false;
+}
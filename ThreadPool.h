@@ -0,0 +1,122 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads with a queue each. A worker runs the
+ *        tasks of its own queue newest first, and when that is empty steals
+ *        the oldest from the others, so uneven tasks keep every thread busy.
+ *        Tasks submitted from outside are dealt round the queues; tasks
+ *        submitted by a worker go on its own queue. The threads are started
+ *        once and kept, so a pool can be shared by any number of jobs.
+ * @see   ParallelJsonLines, ValidateBatch
+ */
+class ThreadPool
+{
+public:
+  /**
+   * @brief Constructor that starts the worker threads.
+   * @param threads Number of threads, or 0 for one per hardware thread.
+   */
+  explicit ThreadPool(unsigned threads = 0);
+
+  /**
+   * @brief Destructor that runs the tasks still queued, then stops the threads.
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @brief Queue a task to run on a worker thread.
+   * @param task Task, which must not throw.
+   */
+  void Submit(std::function<void()> task);
+
+  /**
+   * @brief Run body(0) to body(count - 1) on the workers and wait for them
+   *        all. The calling thread runs queued tasks while it waits, so Run()
+   *        may be called from a task.
+   * @param count Number of calls.
+   * @param body Function called with each index.
+   * @throws The first exception thrown by body, once every call is done.
+   */
+  void Run(size_t count, const std::function<void(size_t)>& body);
+
+  /**
+   * @brief Run queued tasks on the calling thread until done() holds, then
+   *        only wait, so a thread waiting on tasks of the pool, a task
+   *        itself for instance, never waits on a queue nobody is serving.
+   * @param lock Lock held on the mutex guarding what done() reads; it is
+   *        released while a task runs and held again on return.
+   * @param ready Condition notified under that mutex when done() may hold.
+   * @param done Predicate checked with the lock held.
+   */
+  void Wait(std::unique_lock<std::mutex>& lock, std::condition_variable& ready,
+            const std::function<bool()>& done);
+
+  /**
+   * @brief Get the number of worker threads.
+   * @return unsigned
+   */
+  inline unsigned Size() const { return static_cast<unsigned>(_queues.size()); }
+
+  /**
+   * @brief Get the index of the calling thread among the workers, for
+   *        keeping state per worker.
+   * @return Index from 0 to Size() - 1, or Size() if the calling thread is
+   *         not a worker of this pool.
+   */
+  unsigned WorkerIndex() const;
+
+  /**
+   * @brief Get a pool shared by the whole process, with one thread per
+   *        hardware thread, started on first use.
+   * @return ThreadPool&
+   */
+  static ThreadPool& Shared();
+
+private:
+  /**
+   * @brief Tasks queued for one worker.
+   */
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void Work(unsigned index);
+
+  /**
+   * @brief Run one queued task, taken from the back of the queue of the
+   *        calling worker or else stolen from the front of another.
+   * @return false if every queue is empty.
+   */
+  bool RunOne();
+
+  // Made before the threads start, which read it while the rest are started
+  std::vector<std::unique_ptr<Queue>> _queues;
+  std::vector<std::thread> _threads;
+
+  // Queue the next task from outside the pool goes on
+  std::atomic<size_t> _next{0};
+
+  // Tasks queued and not yet taken; raised under _mutex so no wakeup is lost
+  std::atomic<size_t> _pending{0};
+  std::mutex _mutex;
+  std::condition_variable _wake;
+  bool _stopping = false;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,323 @@
+#include <cstdint>
+#include <cstring>
+
+#include "Utf8Validator.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define UTF8_VALIDATOR_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+#ifdef UTF8_VALIDATOR_X86
+// Errors a pair of bytes can show, one bit each. A pair is looked up by the
+// high nibble of the first byte, its low nibble, and the high nibble of the
+// second byte; a bit set in all three lookups is an error. Two continuation
+// bytes in a row are only an error if no lead byte two or three back asks for
+// them, which is checked separately.
+constexpr uint8_t kTooShort = 1 << 0;     // Lead byte then ASCII or another lead
+constexpr uint8_t kTooLong = 1 << 1;      // ASCII then a continuation
+constexpr uint8_t kOverlong3 = 1 << 2;    // 11100000 100_____
+constexpr uint8_t kTooLarge = 1 << 3;     // 11110100 1001____ and above
+constexpr uint8_t kSurrogate = 1 << 4;    // 11101101 101_____
+constexpr uint8_t kOverlong2 = 1 << 5;    // 1100000_ 10______
+constexpr uint8_t kTooLarge1000 = 1 << 6; // 11110101 1000____ and above
+constexpr uint8_t kOverlong4 = 1 << 6;    // 11110000 1000____
+constexpr uint8_t kTwoConts = 1 << 7;     // 10______ 10______
+constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+alignas(16) constexpr uint8_t kByte1High[16] = {
+  kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+  kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+  kTooShort | kOverlong2,
+  kTooShort,
+  kTooShort | kOverlong3 | kSurrogate,
+  kTooShort | kTooLarge | kTooLarge1000 | kOverlong4
+};
+
+alignas(16) constexpr uint8_t kByte1Low[16] = {
+  kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+  kCarry | kOverlong2,
+  kCarry,
+  kCarry,
+  kCarry | kTooLarge,
+  kCarry | kTooLarge | kTooLarge1000,
+  kCarry | kTooLarge | kTooLarge1000,
+  kCarry | kTooLarge | kTooLarge1000,
+  kCarry | kTooLarge | kTooLarge1000,
+  kCarry | kTooLarge | kTooLarge1000,
+  kCarry | kTooLarge | kTooLarge1000,
+  kCarry | kTooLarge | kTooLarge1000,
+  kCarry | kTooLarge | kTooLarge1000,
+  kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+  kCarry | kTooLarge | kTooLarge1000,
+  kCarry | kTooLarge | kTooLarge1000
+};
+
+alignas(16) constexpr uint8_t kByte2High[16] = {
+  kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+  kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+  kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+  kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+  kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+  kTooShort, kTooShort, kTooShort, kTooShort
+};
+
+// Largest value of each of the last three bytes of a vector which doesn't
+// start a sequence running into the next vector
+alignas(32) constexpr uint8_t kIncomplete[32] = {
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 0xEF, 0xDF, 0xBF
+};
+
+/**
+ * @brief Validation state of the SSE4.2 kernel, carried from one vector to
+ *        the next.
+ */
+struct Sse42State
+{
+  __m128i error;
+  __m128i prevInput;
+  __m128i prevIncomplete;
+
+  __attribute__((target("sse4.2")))
+  inline void Check(__m128i input)
+  {
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i byte1HighTable = _mm_load_si128(reinterpret_cast<const __m128i*>(kByte1High));
+    const __m128i byte1LowTable = _mm_load_si128(reinterpret_cast<const __m128i*>(kByte1Low));
+    const __m128i byte2HighTable = _mm_load_si128(reinterpret_cast<const __m128i*>(kByte2High));
+
+    __m128i prev1 = _mm_alignr_epi8(input, prevInput, 15);
+    __m128i byte1High = _mm_shuffle_epi8(byte1HighTable, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    __m128i byte1Low = _mm_shuffle_epi8(byte1LowTable, _mm_and_si128(prev1, nibble));
+    __m128i byte2High = _mm_shuffle_epi8(byte2HighTable, _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+    __m128i special = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+    // Continuations two and three bytes after a three or four byte lead
+    __m128i third = _mm_subs_epu8(_mm_alignr_epi8(input, prevInput, 14), _mm_set1_epi8(0xE0 - 0x80));
+    __m128i fourth = _mm_subs_epu8(_mm_alignr_epi8(input, prevInput, 13), _mm_set1_epi8(0xF0 - 0x80));
+    __m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+
+    error = _mm_or_si128(error, _mm_xor_si128(must23, special));
+    prevInput = input;
+  }
+
+  __attribute__((target("sse4.2")))
+  inline void CheckBlock(const uint8_t* block)
+  {
+    __m128i in[4];
+    for (unsigned i = 0; i < 4; i++) {
+      in[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+    }
+    __m128i any = _mm_or_si128(_mm_or_si128(in[0], in[1]), _mm_or_si128(in[2], in[3]));
+    if (_mm_movemask_epi8(any) == 0) {
+      error = _mm_or_si128(error, prevIncomplete);
+      return;
+    }
+    for (unsigned i = 0; i < 4; i++) {
+      Check(in[i]);
+    }
+    prevIncomplete = _mm_subs_epu8(in[3], _mm_loadu_si128(reinterpret_cast<const __m128i*>(kIncomplete + 16)));
+  }
+};
+
+/**
+ * @brief Validation state of the AVX2 kernel, carried from one vector to
+ *        the next.
+ */
+struct Avx2State
+{
+  __m256i error;
+  __m256i prevInput;
+  __m256i prevIncomplete;
+
+  __attribute__((target("avx2")))
+  inline void Check(__m256i input)
+  {
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i byte1HighTable = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kByte1High)));
+    const __m256i byte1LowTable = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kByte1Low)));
+    const __m256i byte2HighTable = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kByte2High)));
+
+    // Bytes shifted in from the previous vector cross the 128-bit lanes
+    __m256i carried = _mm256_permute2x128_si256(prevInput, input, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(input, carried, 15);
+    __m256i byte1High = _mm256_shuffle_epi8(byte1HighTable, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    __m256i byte1Low = _mm256_shuffle_epi8(byte1LowTable, _mm256_and_si256(prev1, nibble));
+    __m256i byte2High = _mm256_shuffle_epi8(byte2HighTable, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+    __m256i special = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+    __m256i third = _mm256_subs_epu8(_mm256_alignr_epi8(input, carried, 14), _mm256_set1_epi8(0xE0 - 0x80));
+    __m256i fourth = _mm256_subs_epu8(_mm256_alignr_epi8(input, carried, 13), _mm256_set1_epi8(0xF0 - 0x80));
+    __m256i must23 = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+
+    error = _mm256_or_si256(error, _mm256_xor_si256(must23, special));
+    prevInput = input;
+  }
+
+  __attribute__((target("avx2")))
+  inline void CheckBlock(const uint8_t* block)
+  {
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    if (_mm256_movemask_epi8(_mm256_or_si256(low, high)) == 0) {
+      error = _mm256_or_si256(error, prevIncomplete);
+      return;
+    }
+    Check(low);
+    Check(high);
+    prevIncomplete = _mm256_subs_epu8(high, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kIncomplete)));
+  }
+};
+#endif
+
+/**
+ * @brief Copy the last partial block, padded with NUL, which is ASCII.
+ */
+inline const uint8_t* PadTail(const uint8_t* data, size_t size, size_t offset, uint8_t* tail)
+{
+  std::memset(tail, 0, 64);
+  std::memcpy(tail, data + offset, size - offset);
+  return tail;
+}
+
+#ifdef UTF8_VALIDATOR_X86
+__attribute__((target("sse4.2")))
+bool ValidSse42(const uint8_t* data, size_t size)
+{
+  Sse42State state{_mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128()};
+  uint8_t tail[64];
+  for (size_t offset = 0; offset < size; offset += 64) {
+    state.CheckBlock(size - offset >= 64 ? data + offset : PadTail(data, size, offset, tail));
+  }
+  __m128i error = _mm_or_si128(state.error, state.prevIncomplete);
+  return _mm_testz_si128(error, error);
+}
+
+__attribute__((target("avx2")))
+bool ValidAvx2(const uint8_t* data, size_t size)
+{
+  Avx2State state{_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()};
+  uint8_t tail[64];
+  for (size_t offset = 0; offset < size; offset += 64) {
+    state.CheckBlock(size - offset >= 64 ? data + offset : PadTail(data, size, offset, tail));
+  }
+  __m256i error = _mm256_or_si256(state.error, state.prevIncomplete);
+  return _mm256_testz_si256(error, error);
+}
+#endif
+}
+
+bool Utf8Validator::Valid(const char* data, size_t size, Kernel kernel)
+{
+  switch (kernel)
+  {
+#ifdef UTF8_VALIDATOR_X86
+    case Kernel::Avx2:
+      return ValidAvx2(reinterpret_cast<const uint8_t*>(data), size);
+    case Kernel::Sse42:
+      return ValidSse42(reinterpret_cast<const uint8_t*>(data), size);
+#endif
+    default:
+      return FindInvalid(data, size) == size;
+  }
+}
+
+size_t Utf8Validator::FindInvalid(const char* data, size_t size)
+{
+  const char* end = data + size;
+  const char* position = data;
+  while (position != end)
+  {
+    // Skip ASCII eight bytes at a time
+    if (end - position >= 8)
+    {
+      uint64_t word;
+      std::memcpy(&word, position, 8);
+      if ((word & 0x8080808080808080ull) == 0)
+      {
+        position += 8;
+        continue;
+      }
+    }
+    size_t length = SequenceLength(position, end);
+    if (length == 0)
+    {
+      return position - data;
+    }
+    position += length;
+  }
+  return size;
+}
+
+size_t Utf8Validator::SequenceLength(const char* begin, const char* end)
+{
+  const unsigned char* s = reinterpret_cast<const unsigned char*>(begin);
+  size_t available = end - begin;
+  auto continuation = [&](size_t i) { return i < available && (s[i] & 0xC0) == 0x80; };
+
+  if (s[0] < 0x80)
+  {
+    return 1;
+  }
+  if (s[0] < 0xC2)
+  {
+    // A stray continuation, or an overlong two byte form
+    return 0;
+  }
+  if (s[0] < 0xE0)
+  {
+    return continuation(1) ? 2 : 0;
+  }
+  if (s[0] < 0xF0)
+  {
+    if (!continuation(1) || !continuation(2) ||
+        (s[0] == 0xE0 && s[1] < 0xA0) ||   // Overlong
+        (s[0] == 0xED && s[1] >= 0xA0))    // Surrogate
+    {
+      return 0;
+    }
+    return 3;
+  }
+  if (s[0] < 0xF5)
+  {
+    if (!continuation(1) || !continuation(2) || !continuation(3) ||
+        (s[0] == 0xF0 && s[1] < 0x90) ||   // Overlong
+        (s[0] == 0xF4 && s[1] >= 0x90))    // Above U+10FFFF
+    {
+      return 0;
+    }
+    return 4;
+  }
+  return 0;
+}
+
+Utf8Validator::Kernel Utf8Validator::BestKernel()
+{
+  static const Kernel best = Supported(Kernel::Avx2) ? Kernel::Avx2
+                           : Supported(Kernel::Sse42) ? Kernel::Sse42
+                           : Kernel::Scalar;
+  return best;
+}
+
+bool Utf8Validator::Supported(Kernel kernel)
+{
+  switch (kernel)
+  {
+#ifdef UTF8_VALIDATOR_X86
+    case Kernel::Avx2:
+      return __builtin_cpu_supports("avx2");
+    case Kernel::Sse42:
+      return __builtin_cpu_supports("sse4.2");
+#endif
+    case Kernel::Scalar:
+      return true;
+    default:
+      return false;
+  }
+}
@@ -0,0 +1,78 @@
+#ifndef UTF8_VALIDATOR_H
+#define UTF8_VALIDATOR_H
+
+#include <cstddef>
+
+/**
+ * @brief Checks that text is valid UTF-8: no overlong forms, surrogates,
+ *        code points above U+10FFFF, or truncated sequences.
+ *        Whole buffers are checked 64 bytes at a time with AVX2 or SSE4.2 when
+ *        the CPU has them, chosen at run time, using the lookup table method
+ *        of Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction
+ *        Per Byte". Blocks of ASCII cost a single test.
+ * @see   Utf8Validation
+ */
+class Utf8Validator
+{
+public:
+  /**
+   * @brief Instruction sets a buffer can be checked with.
+   */
+  enum class Kernel
+  {
+    Scalar,
+    Sse42,
+    Avx2
+  };
+
+  /**
+   * @brief Check a buffer with the best kernel the CPU supports.
+   * @param data Start of the text.
+   * @param size Length of the text.
+   * @return bool
+   */
+  static inline bool Valid(const char* data, size_t size)
+  {
+    return Valid(data, size, BestKernel());
+  }
+
+  /**
+   * @brief Check a buffer with the given kernel, which the CPU must support.
+   * @param data Start of the text.
+   * @param size Length of the text.
+   * @param kernel Kernel to use.
+   * @return bool
+   */
+  static bool Valid(const char* data, size_t size, Kernel kernel);
+
+  /**
+   * @brief Find the first invalid sequence in a buffer, one byte at a time.
+   *        Meant for reporting where Valid() failed.
+   * @param data Start of the text.
+   * @param size Length of the text.
+   * @return Offset of the first invalid sequence, or size if there is none.
+   */
+  static size_t FindInvalid(const char* data, size_t size);
+
+  /**
+   * @brief Get the length of the sequence starting at a byte.
+   * @param begin Start of the sequence.
+   * @param end End of the text.
+   * @return Length of the sequence, from 1 to 4, or 0 if it is invalid.
+   */
+  static size_t SequenceLength(const char* begin, const char* end);
+
+  /**
+   * @brief Get the best kernel the CPU supports.
+   * @return Kernel
+   */
+  static Kernel BestKernel();
+
+  /**
+   * @brief Check whether the CPU supports a kernel.
+   * @return bool
+   */
+  static bool Supported(Kernel kernel);
+};
+
+#endif // UTF8_VALIDATOR_H
@@ -0,0 +1,96 @@
+#ifndef VALIDATE_BATCH_H
+#define VALIDATE_BATCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "ThreadPool.h"
+#include "ValidatedJson.h"
+
+/**
+ * @brief Construct T from each of many independent JSON documents on the
+ *        threads of a pool, without throwing. Each document is bound
+ *        straight from its text as by ValidateText().
+ *        The documents are split into ranges, a few per thread, which the
+ *        pool's workers steal from each other, so a mix of small and large
+ *        documents keeps every thread busy. Every thread reads with one copy
+ *        of the parser's settings; no parser is used, so several batches may
+ *        run on one pool at once. Each worker keeps one set of JsonTextBuffers
+ *        for the batch, so its structural index and reader scratch are
+ *        allocated once rather than per document; a range run while the
+ *        worker's buffers are in use, from a nested Run() for instance, reads
+ *        in buffers of its own.
+ * @param documents Start of the documents, which must outlive the call.
+ * @param count Number of documents.
+ * @param mode Whether to stop at the first error in a document or collect all.
+ * @param parser Parser whose settings to read with, by default the calling
+ *        thread's parser.
+ * @param pool Threads to bind on, by default the shared pool.
+ * @return One ValidationResult<T> per document, in the same order.
+ */
+template<typename T>
+std::vector<ValidationResult<T>> ValidateBatch(const std::string_view* documents, size_t count,
+                                               ValidationMode mode = ValidationMode::FirstError,
+                                               JsonParser& parser = JsonParser::ThreadLocal(),
+                                               ThreadPool& pool = ThreadPool::Shared())
+{
+  const JsonParserSettings settings = parser.GetSettings();
+
+  // Placeholders without errors, which allocate nothing; each result is
+  // moved over its placeholder once it is bound
+  std::vector<ValidationResult<T>> results;
+  results.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    results.emplace_back(ValidationErrors());
+  }
+
+  // Buffers per worker, and last those of threads outside the pool
+  struct WorkerBuffers
+  {
+    JsonTextBuffers buffers;
+    std::atomic<bool> busy{false};
+  };
+  std::vector<WorkerBuffers> workers(pool.Size() + 1);
+
+  const size_t grain = std::max<size_t>(1, count / (pool.Size() * size_t(8)));
+  const size_t ranges = (count + grain - 1) / grain;
+  pool.Run(ranges, [&](size_t range) {
+    WorkerBuffers& worker = workers[std::min(pool.WorkerIndex(), pool.Size())];
+    JsonTextBuffers own;
+    bool borrowed = !worker.busy.exchange(true, std::memory_order_acquire);
+    JsonTextBuffers& buffers = borrowed ? worker.buffers : own;
+
+    size_t end = std::min(count, (range + 1) * grain);
+    for (size_t i = range * grain; i < end; i++) {
+      results[i] = ValidateText<T>(documents[i], mode, settings, buffers);
+    }
+    if (borrowed) {
+      worker.busy.store(false, std::memory_order_release);
+    }
+  });
+  return results;
+}
+
+/**
+ * @brief Construct T from each of many independent JSON documents on the
+ *        threads of a pool, without throwing.
+ * @param documents The documents, which must outlive the call.
+ * @param mode Whether to stop at the first error in a document or collect all.
+ * @param parser Parser whose settings to read with, by default the calling
+ *        thread's parser.
+ * @param pool Threads to bind on, by default the shared pool.
+ * @return One ValidationResult<T> per document, in the same order.
+ */
+template<typename T>
+std::vector<ValidationResult<T>> ValidateBatch(const std::vector<std::string_view>& documents,
+                                               ValidationMode mode = ValidationMode::FirstError,
+                                               JsonParser& parser = JsonParser::ThreadLocal(),
+                                               ThreadPool& pool = ThreadPool::Shared())
+{
+  return ValidateBatch<T>(documents.data(), documents.size(), mode, parser, pool);
+}
+
+#endif // VALIDATE_BATCH_H
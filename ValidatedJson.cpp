@@ -1,56 +1,271 @@
 
+#include <cstdint>
 #include <string>
 #include <stdexcept>
 #include <sstream>
 #include <fstream>
 #include <json/json.h>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <type_traits>
 
+#include "Utf8Validator.h"
 #include "ValidatedJson.h"
 
-JsonData::JsonData(std::istream&& stream)
+JsonData::JsonData(std::istream&& stream, JsonParser& parser)
 {
   if (!stream.good())
   {
     throw std::runtime_error("Invalid input stream for JSON data.");
   }
 
-  Json::parseFromStream(Json::CharReaderBuilder(), stream, &_root, &_errors);
+  std::string text{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+  Parse(text.data(), text.data() + text.size(), parser);
+}
+
+JsonData::JsonData(const char* begin, const char* end, JsonParser& parser)
+{
+  Parse(begin, end, parser);
+}
 
-  if (!_errors.empty())
+void JsonData::Parse(const char* begin, const char* end, JsonParser& parser)
+{
+  auto root = std::make_shared<Json::Value>();
+  if (!parser.Parse(begin, end, *root, _errors))
   {
     throw std::runtime_error("JSON parsing error: " + _errors);
   }
+
+  _root = std::move(root);
+}
+
+JsonData::JsonData(Json::Value&& root) :
+  _root(std::make_shared<const Json::Value>(std::move(root)))
+{}
+
+JsonData::JsonData(const Json::Value& root) :
+  _root(std::make_shared<const Json::Value>(root))
+{}
+
+JsonData::JsonData(std::shared_ptr<const Json::Value> root) :
+  _root(std::move(root))
+{}
+
+JsonData::JsonData(JsonReader* reader) :
+  _reader(reader)
+{}
+
+const Json::Value& JsonData::Materialise() const
+{
+  auto root = std::make_shared<Json::Value>();
+  if (_members)
+  {
+    // The object has been passed; read the members ScanMembers() found
+    *root = Json::Value(Json::objectValue);
+    for (const auto& [name, position] : _members->positions)
+    {
+      _members->reader.Seek(position);
+      _members->reader.ReadValue((*root)[name]);
+    }
+  }
+  else
+  {
+    if (_consumed)
+    {
+      throw std::logic_error("JSON text has already been bound");
+    }
+    _consumed = true;
+
+    _reader->ReadValue(*root);
+    if (!_nested)
+    {
+      _reader->Finish();
+    }
+  }
+  _root = std::move(root);
+  return *_root;
 }
 
-JsonData::JsonData(const Json::Value root) :
-  _root(root)
+bool JsonData::ScanMembers() const
+{
+  if (_members)
+  {
+    return true;
+  }
+  if (!_reader || _root || _consumed || _reader->Peek() != JsonToken::Object)
+  {
+    return false;
+  }
+  _consumed = true;
+
+  _reader->BeginObject();
+  auto members = std::make_shared<TextMembers>(TextMembers{*_reader, {}});
+  std::string_view name;
+  while (_reader->NextMember(name))
+  {
+    const char* position = _reader->Position();
+    auto [member, added] = members->positions.try_emplace(std::string(name), position);
+    if (!added)
+    {
+      if (_reader->GetSettings().rejectDuplicateKeys)
+      {
+        _reader->Error("Duplicate key: '" + std::string(name) + "'");
+      }
+      // As when parsing into a tree, the last duplicate wins
+      member->second = position;
+    }
+    _reader->Skip();
+  }
+  if (!_nested)
+  {
+    _reader->Finish();
+  }
+  _members = std::move(members);
+  return true;
+}
+
+JsonReader* JsonData::MemberReader(const std::string& key) const
+{
+  auto member = _members->positions.find(key);
+  if (member == _members->positions.end())
+  {
+    return nullptr;
+  }
+  _members->reader.Seek(member->second);
+  return &_members->reader;
+}
+
+JsonData JsonData::View(const Json::Value& value,
+                        const std::shared_ptr<const Json::Value>& owner)
+{
+  JsonData data;
+  data._view = &value;
+  data._owner = &owner;
+  return data;
+}
+
+JsonFile::JsonFile(const std::string& path, JsonParser& parser) :
+  JsonFile(MappedFile(path), parser)
+{}
+
+JsonFile::JsonFile(const MappedFile& file, JsonParser& parser) :
+  JsonData(file.Data(), file.Data() + file.Size(), parser)
+{}
+
+JsonString::JsonString(std::string_view string, JsonParser& parser) :
+  JsonData(string.data(), string.data() + string.size(), parser)
 {}
 
-JsonFile::JsonFile(const std::string& path) :
-  JsonData(Open(path))
+JsonString::JsonString(const char* data, size_t size, JsonParser& parser) :
+  JsonData(data, data + size, parser)
 {}
 
-std::ifstream JsonFile::Open(const std::string& path)
+JsonText::JsonText(std::string_view text, JsonParser& parser) :
+  JsonText(text, parser.GetSettings())
+{}
+
+JsonText::JsonText(std::string_view text, const JsonParserSettings& settings) :
+  JsonText(text, settings, _ownBuffers)
+{}
+
+JsonText::JsonText(std::string_view text, const JsonParserSettings& settings, JsonTextBuffers& buffers) :
+  JsonData(&_textReader),
+  _buffers(buffers),
+  _textReader(text.data(), text.data() + text.size(), settings, PrepareText(text, settings))
+{
+  _textReader.SwapScratch(_buffers.scratch);
+}
+
+JsonText::~JsonText()
+{
+  _textReader.SwapScratch(_buffers.scratch);
+}
+
+const JsonIndex* JsonText::PrepareText(std::string_view text, const JsonParserSettings& settings)
 {
-  std::ifstream ifs;
-  ifs.open(path);
-  if (!ifs.is_open())
+  if (settings.utf8 == Utf8Validation::Buffer && !Utf8Validator::Valid(text.data(), text.size()))
+  {
+    const char* invalid = text.data() + Utf8Validator::FindInvalid(text.data(), text.size());
+    throw JsonSyntaxError::At(text.data(), invalid, "Invalid UTF-8");
+  }
+
+  // Without a complete index the reader finds the unclosed string itself
+  if (!settings.structuralIndex || text.size() >= UINT32_MAX || !_buffers.index.Build(text.data(), text.size()))
   {
-    throw std::runtime_error("Could not open JSON file: " + path);
+    return nullptr;
   }
-  return ifs;
+  return &_buffers.index;
 }
 
-JsonString::JsonString(const std::string& string) :
-  JsonData(std::stringstream(string))
+ValidatedJson::ValidatedJson(JsonData&& data, JsonStorage storage) :
+  _source(&data),
+  _context(data._context)
+{
+  // Text is bound while it is read, so there is never a tree to retain
+  if (storage == JsonStorage::Retain && !data._reader)
+  {
+    _root = data._view ? data.GetSnapshot() : std::move(data._root);
+  }
+  data._binding.Attach(this);
+}
+
+ValidatedJson::ValidatedJson(const JsonData& data, JsonStorage storage) :
+  _source(&data),
+  _context(data._context)
+{
+  if (storage == JsonStorage::Retain && !data._reader)
+  {
+    _root = data.GetSnapshot();
+  }
+  data._binding.Attach(this);
+}
+
+ValidatedJson::ValidatedJson(const ValidatedJson& other) :
+  _root(other._root)
 {}
 
-ValidatedJson::ValidatedJson(const JsonData& data) :
-  _root(data.GetRoot())
+ValidatedJson::ValidatedJson(ValidatedJson&& other) noexcept :
+  _root(std::move(other._root))
 {}
 
+ValidatedJson& ValidatedJson::operator=(const ValidatedJson& other)
+{
+  _root = other._root;
+  if (_source)
+  {
+    _source->_binding.Forget(this);
+  }
+  Detach();
+  return *this;
+}
+
+ValidatedJson& ValidatedJson::operator=(ValidatedJson&& other) noexcept
+{
+  _root = std::move(other._root);
+  if (_source)
+  {
+    _source->_binding.Forget(this);
+  }
+  Detach();
+  return *this;
+}
+
+// Off unless turned on, as element constructors may not be thread-safe
+std::atomic<size_t> ValidatedJson::_parallelThreshold{0};
+std::atomic<ThreadPool*> ValidatedJson::_parallelPool{nullptr};
+
+void ValidatedJson::SetParallelArrays(size_t threshold, ThreadPool* pool)
+{
+  _parallelThreshold = threshold;
+  _parallelPool = pool;
+}
+
+void ValidatedJson::Fail(const std::string& message) const
+{
+  Report(_context, message);
+}
+
 // Special case for default value supplied to strings
 void ValidatedJson::Optional(const std::string& key, std::string& value, const char* defaultValue) const {
   Optional(key, value, std::string(defaultValue));
@@ -1,13 +1,32 @@
 #ifndef VALIDATED_JSON_H
 #define VALIDATED_JSON_H
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <exception>
 #include <string>
+#include <string_view>
 #include <stdexcept>
 #include <sstream>
 #include <fstream>
+#include <functional>
 #include <json/json.h>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "JsonFields.h"
+#include "JsonParser.h"
+#include "JsonReader.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include "ValidationResult.h"
 
 /**
  * @brief Type trait to check if a type is a std::vector<T>.
@@ -20,6 +39,92 @@ struct is_vector : std::false_type {};
 template<typename T, typename Alloc>
 struct is_vector<std::vector<T, Alloc>> : std::true_type {};
 
+/**
+ * @brief Type trait to check if a type is an integer type bound from a JSON
+ *        number: any signed or unsigned integer type, int8_t and uint8_t
+ *        included, but bool and the character types char, wchar_t, char16_t
+ *        and char32_t.
+ */
+template<typename T>
+struct is_json_integer : std::bool_constant<std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                                            !std::is_same_v<T, char> && !std::is_same_v<T, wchar_t> &&
+                                            !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>> {};
+
+/**
+ * @brief Type trait to check if a type is bound from a JSON number.
+ */
+template<typename T>
+struct is_json_number : std::bool_constant<is_json_integer<T>::value || std::is_same_v<T, double>> {};
+
+/**
+ * @brief Field which hands each element of a JSON array to a callback as it
+ *        is bound, in place of a std::vector<T> holding them all.
+ *        Elements are checked exactly as for std::vector<T>; one which fails
+ *        is reported at its index and not handed on, and those handed on
+ *        before an error stay handed on. Bound from JsonText, the elements
+ *        are read from the text one at a time, so memory use does not grow
+ *        with the length of the array. Bound from a tree the array is in the
+ *        tree, but is never copied.
+ */
+template<typename T>
+class JsonArraySink
+{
+public:
+  using value_type = T;
+
+  /**
+   * @brief Constructor for a sink which only counts the elements.
+   */
+  JsonArraySink() = default;
+
+  /**
+   * @brief Constructor that hands elements to a callback.
+   * @param callback Called with each valid element, in order.
+   */
+  explicit JsonArraySink(std::function<void(T&&)> callback) :
+    _callback(std::move(callback))
+  {}
+
+  /**
+   * @brief Hand an element to the callback.
+   * @param element The element.
+   */
+  inline void Push(T&& element)
+  {
+    _count++;
+    if (_callback) {
+      _callback(std::move(element));
+    }
+  }
+
+  /**
+   * @brief Get the number of elements handed on.
+   * @return size_t
+   */
+  inline size_t Count() const { return _count; }
+
+private:
+  std::function<void(T&&)> _callback;
+  size_t _count = 0;
+};
+
+/**
+ * @brief Type trait to check if a type is a JsonArraySink<T>.
+ */
+template<typename T>
+struct is_array_sink : std::false_type {};
+/**
+ * @brief Type trait to check if a type is a JsonArraySink<T>.
+ */
+template<typename T>
+struct is_array_sink<JsonArraySink<T>> : std::true_type {};
+
+class JsonData;
+class ValidatedJson;
+
+template<typename T, typename... Args>
+ValidationResult<T> Validate(JsonData&& data, ValidationMode mode = ValidationMode::FirstError, Args&&... args);
+
 /**
  *  @brief Class to parse JSON data which is provided to a ValidatedJson class.
  *  @see   ValidatedJson, JsonFile, JsonString
@@ -30,27 +135,212 @@ public:
   /**
    * @brief Constructor that reads JSON data from an input stream.
    * @param stream Input stream containing JSON data.
+   * @param parser Parser to use, by default the calling thread's parser.
    * @throws std::runtime_error if the stream is invalid or if parsing fails.
    */
-  explicit JsonData(std::istream&& stream);
+  explicit JsonData(std::istream&& stream, JsonParser& parser = JsonParser::ThreadLocal());
+
+  /**
+   * @brief Constructor that takes ownership of existing parsed JSON data.
+   * @param root JSON root value, moved into shared storage without copying.
+   */
+  explicit JsonData(Json::Value&& root);
 
   /**
-   * @brief Constructor that takes existing parsed JSON data.
+   * @brief Constructor that copies existing parsed JSON data.
    * @param root JSON root value.
    */
-  explicit JsonData(const Json::Value root);
+  explicit JsonData(const Json::Value& root);
+
+  /**
+   * @brief Constructor that shares an existing immutable snapshot.
+   * @param root Snapshot of a JSON root value.
+   */
+  explicit JsonData(std::shared_ptr<const Json::Value> root);
 
   /**
    * @brief Get the Root value of the parsed JSON data.
-   * @return Json::Value 
+   * @return const Json::Value& (a null value if the data has been moved from)
    */
-  inline Json::Value GetRoot() const { return _root; }
+  inline const Json::Value& GetRoot() const
+  {
+    if (_view) {
+      return *_view;
+    }
+    return _root ? *_root : Json::Value::nullSingleton();
+  }
+
+  /**
+   * @brief Get a shared snapshot of the parsed JSON data.
+   *        The snapshot is immutable, so sharing it never copies the tree.
+   *        The snapshot of a view shares ownership of the whole tree.
+   * @return std::shared_ptr<const Json::Value>
+   */
+  inline std::shared_ptr<const Json::Value> GetSnapshot() const
+  {
+    if (_view) {
+      return std::shared_ptr<const Json::Value>(*_owner, _view);
+    }
+    return _root;
+  }
 
 protected:
-  Json::Value _root;
+  /**
+   * @brief Constructor that parses JSON data directly from memory.
+   * @param begin Start of the JSON text.
+   * @param end End of the JSON text.
+   * @param parser Parser to use.
+   * @throws std::runtime_error if parsing fails.
+   */
+  JsonData(const char* begin, const char* end, JsonParser& parser);
+
+  /**
+   * @brief Constructor for data read straight from text by a reader.
+   * @param reader Reader positioned at the value to bind, which must
+   *        outlive the binding.
+   */
+  explicit JsonData(JsonReader* reader);
+
+  // Built on first use when reading from text, see Source()
+  mutable std::shared_ptr<const Json::Value> _root;
 
 private:
+  JsonData() = default;
+
+  /**
+   * @brief Create a non-owning view of a value inside an existing tree, for
+   *        binding a nested object. Nothing is copied, not even the handle:
+   *        the view refers to owner itself, so the shared_ptr object owner
+   *        (not just the tree it holds) must outlive the view.
+   * @param value Value to view, which must be part of the tree held by owner.
+   * @param owner Handle of the tree containing value.
+   * @return JsonData
+   */
+  static JsonData View(const Json::Value& value,
+                       const std::shared_ptr<const Json::Value>& owner);
+
+  /**
+   * @brief Parse JSON text into _root.
+   * @throws std::runtime_error if parsing fails.
+   */
+  void Parse(const char* begin, const char* end, JsonParser& parser);
+
+  /**
+   * @brief Get the value to bind, reading it into a tree first when the data
+   *        is read from text and a class asks for the tree.
+   * @return const Json::Value&
+   */
+  inline const Json::Value& Source() const
+  {
+    return _reader && !_root ? Materialise() : GetRoot();
+  }
+
+  /**
+   * @brief Read the value at the reader into _root.
+   * @throws std::logic_error if the value has already been read.
+   */
+  const Json::Value& Materialise() const;
+
+  /**
+   * @brief Get the reader to bind from, unless the data is already a tree
+   *        or its members have been found by ScanMembers().
+   * @return JsonReader*
+   */
+  inline JsonReader* Reader() const
+  {
+    return _root || _members ? nullptr : _reader;
+  }
+
+  /**
+   * @brief Find the members of the object at the reader by skipping over
+   *        their values, the first time a class asks for a member by name.
+   *        Each member is then only read if it is asked for.
+   * @return false if the data is not an object read from text.
+   */
+  bool ScanMembers() const;
+
+  /**
+   * @brief Get a reader positioned at the value of a member found by
+   *        ScanMembers(); valid until the next call.
+   * @param key Member name.
+   * @return JsonReader*, or nullptr if the object has no such member.
+   */
+  JsonReader* MemberReader(const std::string& key) const;
+
+  /**
+   * @brief Members of an object read from text, see ScanMembers().
+   */
+  struct TextMembers
+  {
+    // Copy of the reader from inside the object, for reading its members
+    JsonReader reader;
+    // Position of the value of each member, by name
+    std::unordered_map<std::string, const char*> positions;
+  };
+
   std::string _errors;
+
+  // Set when reading straight from text, see JsonText
+  JsonReader* _reader = nullptr;
+  // Set for a member of a document read from text, which is followed by
+  // the rest of its document rather than the end of the text
+  bool _nested = false;
+  // Set once the value at the reader has been read
+  mutable bool _consumed = false;
+  // Set once the members of the object at the reader have been found
+  mutable std::shared_ptr<TextMembers> _members;
+
+  // Set for views only; _owner points at the handle passed to View()
+  const Json::Value* _view = nullptr;
+  const std::shared_ptr<const Json::Value>* _owner = nullptr;
+
+  // Set when bound by Validate(), which collects errors instead of throwing
+  ValidationContext* _context = nullptr;
+
+  /**
+   * @brief Link to the object being constructed from the data, which is
+   *        detached from it when the data is destroyed, so that the object
+   *        never refers to data which is gone. A copy of the data starts
+   *        with no object.
+   */
+  class Binding
+  {
+  public:
+    Binding() = default;
+    Binding(const Binding&) {}
+    Binding& operator=(const Binding&) { return *this; }
+    ~Binding() { Detach(); }
+
+    /**
+     * @brief Link an object, detaching any object linked before it.
+     */
+    void Attach(ValidatedJson* object);
+
+    /**
+     * @brief Detach the linked object from the data.
+     */
+    void Detach();
+
+    /**
+     * @brief Drop the link to an object which is being destroyed.
+     */
+    inline void Forget(const ValidatedJson* object)
+    {
+      if (_object == object) {
+        _object = nullptr;
+      }
+    }
+
+  private:
+    ValidatedJson* _object = nullptr;
+  };
+
+  mutable Binding _binding;
+
+  friend class ValidatedJson;
+
+  template<typename T, typename... Args>
+  friend ValidationResult<T> Validate(JsonData&& data, ValidationMode mode, Args&&... args);
 };
 
 /**
@@ -62,18 +352,21 @@ class JsonFile : public JsonData
 public:
   /**
    * @brief Constructor that reads JSON data from a file.
+   *        Regular files are memory mapped and parsed in place; pipes and
+   *        special files are read into memory first.
    * @param path Path to the JSON file.
+   * @param parser Parser to use, by default the calling thread's parser.
    * @throws std::runtime_error if the file cannot be opened.
    */
-  explicit JsonFile(const std::string& path);
+  explicit JsonFile(const std::string& path, JsonParser& parser = JsonParser::ThreadLocal());
 
 private:
   /**
-   * @brief Helper function to open the file and throw an error if it cannot be opened.
-   * @param path Path to the JSON file.
-   * @return std::ifstream 
+   * @brief Constructor that parses the contents of an open file.
+   * @param file Mapped or read file contents.
+   * @param parser Parser to use.
    */
-  static std::ifstream Open(const std::string& path);
+  JsonFile(const MappedFile& file, JsonParser& parser);
 };
 
 // Class to parse JSON data from a string.
@@ -82,9 +375,118 @@ class JsonString : public JsonData
 public:
   /**
    * @brief Constructor that reads JSON data from a string.
-   * @param path The JSON string.
+   *        The text is parsed where it lies, without an intermediate copy.
+   * @param string The JSON string.
+   * @param parser Parser to use, by default the calling thread's parser.
+   */
+  explicit JsonString(std::string_view string, JsonParser& parser = JsonParser::ThreadLocal());
+
+  /**
+   * @brief Constructor that reads JSON data from a raw buffer.
+   *        The text is parsed where it lies, without an intermediate copy.
+   * @param data Start of the JSON text, not necessarily null-terminated.
+   * @param size Length of the JSON text.
+   * @param parser Parser to use, by default the calling thread's parser.
+   */
+  JsonString(const char* data, size_t size, JsonParser& parser = JsonParser::ThreadLocal());
+};
+
+/**
+ * @brief Buffers for reading JSON text, which can be handed from one JsonText
+ *        to the next so that a thread reading many documents allocates them
+ *        once: the structural index and the reader's string scratch.
+ *        Only one JsonText may use them at a time.
+ * @see   JsonText, ValidateBatch
+ */
+struct JsonTextBuffers
+{
+  JsonIndex index;
+  std::string scratch;
+};
+
+/**
+ * @brief JSON text which is bound without being parsed into a tree first.
+ *        Classes which use Bind() read every value straight from the text
+ *        into their members as it is parsed; members with no field are
+ *        skipped. Classes which use Required() and Optional() read their
+ *        object into a tree when they first ask for a key.
+ *        Nothing is parsed until the object is constructed, so the text must
+ *        outlive the construction, and the bound object keeps no tree, as
+ *        with JsonStorage::Release.
+ * @see   JsonData, JsonReader, ValidatedJson::Bind
+ */
+class JsonText : public JsonData
+{
+public:
+  /**
+   * @brief Constructor that prepares to read JSON text.
+   * @param text The JSON text, which must outlive the construction of the
+   *        object bound from it.
+   * @param parser Parser whose settings to read with, by default the calling
+   *        thread's parser.
+   * @throws JsonSyntaxError if the settings ask for Utf8Validation::Buffer
+   *         and the text is not valid UTF-8.
+   */
+  explicit JsonText(std::string_view text, JsonParser& parser = JsonParser::ThreadLocal());
+
+  /**
+   * @brief Constructor that prepares to read JSON text with the given
+   *        settings, without a parser.
+   * @param text The JSON text, which must outlive the construction of the
+   *        object bound from it.
+   * @param settings Settings to read with.
+   * @throws JsonSyntaxError if the settings ask for Utf8Validation::Buffer
+   *         and the text is not valid UTF-8.
+   */
+  JsonText(std::string_view text, const JsonParserSettings& settings);
+
+  /**
+   * @brief Constructor that prepares to read JSON text with the given
+   *        settings, in buffers kept from an earlier JsonText.
+   * @param text The JSON text, which must outlive the construction of the
+   *        object bound from it.
+   * @param settings Settings to read with.
+   * @param buffers Buffers to read in, which are handed back, with any
+   *        capacity they have grown, when the JsonText is destroyed.
+   * @throws JsonSyntaxError if the settings ask for Utf8Validation::Buffer
+   *         and the text is not valid UTF-8.
+   */
+  JsonText(std::string_view text, const JsonParserSettings& settings, JsonTextBuffers& buffers);
+
+  ~JsonText();
+
+  // The base refers to the reader, so the text can't be copied or moved
+  JsonText(const JsonText&) = delete;
+  JsonText& operator=(const JsonText&) = delete;
+
+private:
+  /**
+   * @brief Check the UTF-8 of the whole text and build its structural index,
+   *        if the settings ask for them.
+   * @return The index, or nullptr to read without one.
+   * @throws JsonSyntaxError if the text is not valid UTF-8.
    */
-  explicit JsonString(const std::string& string);
+  const JsonIndex* PrepareText(std::string_view text, const JsonParserSettings& settings);
+
+  // Buffers of this text, unless it was given some to read in
+  JsonTextBuffers _ownBuffers;
+  JsonTextBuffers& _buffers;
+  JsonReader _textReader;
+};
+
+/**
+ * @brief Storage policy which decides whether a ValidatedJson object keeps its
+ *        JSON tree once the derived class has bound its members.
+ *        Each class picks its own policy; nested objects don't inherit it.
+ *        A nested object bound from a tree views its subtree in the parent's
+ *        tree, so a nested object which retains keeps the whole document
+ *        alive, even when its parent releases. For a parent's Release to
+ *        free the document, its nested classes must release too.
+ */
+enum class JsonStorage
+{
+  Retain,   ///< Keep the tree for the lifetime of the object (default).
+  Release   ///< Never keep the tree; only the bound members remain.
 };
 
 /**
@@ -97,24 +499,71 @@ class ValidatedJson
 public:
   /**
    * @brief Get the Root object
-   * @return Json::Value 
+   * @return const Json::Value& (a null value if no data is held, including
+   *         when the tree was released with JsonStorage::Release)
+   */
+  inline const Json::Value& GetRoot() const
+  {
+    return _root ? *_root : Json::Value::nullSingleton();
+  }
+
+  /**
+   * @brief Get a shared snapshot of the Root object.
+   * @return std::shared_ptr<const Json::Value>
+   */
+  inline std::shared_ptr<const Json::Value> GetSnapshot() const { return _root; }
+
+  /**
+   * @brief Turn on binding arrays of nested objects in parallel, which is off
+   *        until this is called. An array bound from a tree with at least
+   *        threshold elements is then split into ranges which are bound on
+   *        the threads of a pool, so the constructors of every element class
+   *        must be safe to run at once; only turn it on when they are.
+   *        Errors come out as if the elements were bound in order. Arrays
+   *        read straight from text are always bound in order. Takes effect
+   *        for arrays bound after the call.
+   * @param threshold Fewest elements to split an array at, e.g. 65536, or 0
+   *        to never split one, the default.
+   * @param pool Threads to bind on, or nullptr for the shared pool. Nothing is
+   *        split when the pool has a single thread.
+   * @return None
    */
-  inline Json::Value GetRoot() const { return _root; }
+  static void SetParallelArrays(size_t threshold, ThreadPool* pool = nullptr);
 
 protected:
   /**
    * @brief Construct a new Validated Json object from JsonData.
-   *        Called from derived classes.
+   *        Called from derived classes. Takes over the parsed tree without
+   *        copying it. A view shares the tree it was created from.
+   *        With JsonStorage::Release the tree is only read while the
+   *        derived constructor runs, and data must stay alive until then.
+   * @param data JsonData object containing the parsed JSON data.
+   * @param storage Whether to keep the tree after construction.
+   */
+  explicit ValidatedJson(JsonData&& data, JsonStorage storage = JsonStorage::Retain);
+
+  /**
+   * @brief Construct a new Validated Json object from JsonData.
+   *        Called from derived classes. Shares the parsed tree with data
+   *        without copying it.
    * @param data JsonData object containing the parsed JSON data.
+   * @param storage Whether to keep the tree after construction.
    */
-  explicit ValidatedJson(const JsonData& data);
+  explicit ValidatedJson(const JsonData& data, JsonStorage storage = JsonStorage::Retain);
 
+  // Copies and moves carry the retained tree only; binding is over by then
   ValidatedJson() = default;
-  ValidatedJson(const ValidatedJson&) = default;
-  ValidatedJson(ValidatedJson&&) = default;
-  ValidatedJson& operator=(const ValidatedJson&) = default;
-  ValidatedJson& operator=(ValidatedJson&&) = default;
-  ~ValidatedJson() = default;
+  ValidatedJson(const ValidatedJson& other);
+  ValidatedJson(ValidatedJson&& other) noexcept;
+  ValidatedJson& operator=(const ValidatedJson& other);
+  ValidatedJson& operator=(ValidatedJson&& other) noexcept;
+
+  inline ~ValidatedJson()
+  {
+    if (_source) {
+      _source->_binding.Forget(this);
+    }
+  }
 
   /**
    * @brief Retrieve a required key from the JSON data.
@@ -126,12 +575,16 @@ protected:
   template<typename T>
   void Required(const std::string& key, T& value) const
   {
-    if (!_root.isMember(key))
-    {
-        throw std::runtime_error("Required key \"" + key + "\" not found");
+    if (Stopped()) {
+      return;
     }
 
-    value = ParseValue<T>(key, _root[key]);
+    // A missing key is reported at the path it should have been found at
+    ValidationContext::Scope scope(_context, key);
+    if (!BindMember(key, value))
+    {
+        Fail("Required key \"" + key + "\" not found");
+    }
   }
 
   /**
@@ -144,13 +597,14 @@ protected:
   template<typename T>
   void Optional(const std::string& key, T& value, const T& defaultValue) const
   {
-    if (!_root.isMember(key))
-    {
-      value = defaultValue;
+    if (Stopped()) {
+      return;
     }
-    else
+
+    ValidationContext::Scope scope(_context, key);
+    if (!BindMember(key, value))
     {
-      value = ParseValue<T>(key, _root[key]);
+      value = defaultValue;
     }
   }
 
@@ -165,63 +619,1124 @@ protected:
    */
   void Optional(const std::string& key, std::string& value, const char* defaultValue) const;
 
+  /**
+   * @brief Declare a required field for Bind().
+   *        Use in the static constexpr Fields() function of a derived class.
+   * @param key Key name, a string literal.
+   * @param member Member to store the value in.
+   * @return RequiredField<C, T>
+   */
+  template<typename C, typename T>
+  static constexpr RequiredField<C, T> Required(const char* key, T C::* member)
+  {
+    return RequiredField<C, T>{key, std::char_traits<char>::length(key), member};
+  }
+
+  /**
+   * @brief Declare an optional field for Bind().
+   *        Use in the static constexpr Fields() function of a derived class.
+   * @param key Key name, a string literal.
+   * @param member Member to store the value in.
+   * @param defaultValue Value to assign if the key is not found. Must be a
+   *        literal type, e.g. a number or a string literal.
+   * @return OptionalField<C, T, D>
+   */
+  template<typename C, typename T, typename D>
+  static constexpr OptionalField<C, T, D> Optional(const char* key, T C::* member, D defaultValue)
+  {
+    return OptionalField<C, T, D>{key, std::char_traits<char>::length(key), member, defaultValue};
+  }
+
+  /**
+   * @brief Bind every field declared by C::Fields() in a single pass over the
+   *        members of the JSON object. Each member is dispatched to its field
+   *        through a compile-time perfect hash of the declared keys; members
+   *        with no field are ignored. Fields are bound, and errors reported,
+   *        in the order C::Fields() declares them, whether the data is a tree
+   *        or text and whatever the order of the members; of duplicate
+   *        members, the last is bound. Call from the
+   *        constructor of the derived class as Bind(*this).
+   * @param self The object being constructed.
+   * @throws std::runtime_error as for Required() and Optional().
+   * @return None
+   */
+  template<typename C>
+  void Bind(C& self) const
+  {
+    BindFields(self, std::make_index_sequence<decltype(C::Fields())::kSize>());
+  }
+
+  /**
+   * @brief Report a validation failure, e.g. from a check in the constructor
+   *        of a derived class. When the object is being bound by Validate()
+   *        the error is recorded and this returns; otherwise it throws.
+   * @param message Description of the failure.
+   * @throws std::runtime_error unless bound by Validate().
+   * @return None
+   */
+  void Fail(const std::string& message) const;
+
 private:
   /**
-   * @brief Parse the value of a key from the JSON data.
-   * @param key Key name to parse.
-   * @return Parsed value of type T.
+   * @brief Whether binding should stop because Validate() has seen an error.
+   * @return bool
    */
-  template<typename T>
-  T ParseValue(const std::string &key, const Json::Value& value) const
+  inline bool Stopped() const { return _context && _context->Stopped(); }
+
+  /**
+   * @brief Get the number of errors Validate() has seen, which without it is
+   *        always 0 since the first error throws.
+   * @return size_t
+   */
+  inline size_t ErrorCount() const { return _context ? _context->ErrorCount() : 0; }
+
+  /**
+   * @brief Get the pool to bind an array of nested objects on.
+   * @param count Number of elements in the array.
+   * @return ThreadPool*, or nullptr to bind the elements in order.
+   */
+  static inline ThreadPool* ParallelPool(size_t count)
   {
-    // Add types here as necessary
-    if constexpr (std::is_same_v<T, std::string>) {
-      if (!value.isString()) {
-        throw std::runtime_error("Expected string value for key: " + key);
-      }
-      return value.asString();
-    } else if constexpr (std::is_same_v<T, int>) {
-      if (!value.isInt()) {
-        throw std::runtime_error("Expected integer value for key: " + key);
-      }
-      if (value.asInt() < Json::Value::minInt || value.asInt() > Json::Value::maxInt) {
-        throw std::runtime_error("Integer value out of range for key: " + key);
-      }
-      return value.asInt();
-    } else if constexpr (std::is_same_v<T, double>) {
-      if (!value.isDouble()) {
-        throw std::runtime_error("Expected double value for key: " + key);
-      }
-      return value.asDouble();
-    } else if constexpr (std::is_same_v<T, bool>) {
-      if (!value.isBool()) {
-        throw std::runtime_error("Expected boolean value for key: " + key);
-      }
-      return value.asBool();
-    } else if constexpr (std::is_base_of_v<ValidatedJson, T>) {
-      // Deal with nested json objects
-      if (!value.isObject()) {
-        throw std::runtime_error("Expected JSON object for key: " + key);
-      }
-      return T(JsonData(value));
-    } else if constexpr (is_vector<T>::value) {
-      std::cout << "vector" << std::endl;
-      // Deal with JSON arrays
-      if (!value.isArray()) {
-        throw std::runtime_error("Expected array for key: " + key);
-      }
-      T result;
-      for (const auto& element : value) {
-        result.emplace_back(ParseValue<typename T::value_type>(key, element));
-      }
-      return result;
-    } else {
-      static_assert(false && sizeof(T), "Unsupported type for ParseValue()");
+    size_t threshold = _parallelThreshold.load(std::memory_order_relaxed);
+    if (threshold == 0 || count < threshold) {
+      return nullptr;
     }
+    ThreadPool* pool = _parallelPool.load(std::memory_order_relaxed);
+    if (!pool) {
+      pool = &ThreadPool::Shared();
+    }
+    return pool->Size() > 1 ? pool : nullptr;
   }
 
-protected:
-  Json::Value _root;
-};
+  /**
+   * @brief Report a failure to the given context, as Fail() does to ours.
+   * @param context Context to report to, or nullptr to throw.
+   * @param message Description of the failure.
+   * @throws std::runtime_error without a context.
+   * @return None
+   */
+  static inline void Report(ValidationContext* context, const std::string& message)
+  {
+    if (!context) {
+      throw std::runtime_error(message);
+    }
+    context->Report(message);
+  }
+
+  /**
+   * @brief Make a view of a nested value for binding a nested object.
+   * @return JsonData
+   */
+  inline JsonData ViewOf(const Json::Value& value) const
+  {
+    return ViewOf(value, Owner(), _context);
+  }
+
+  /**
+   * @brief Make a view of a nested value of the tree held by owner, bound
+   *        with the given context.
+   * @return JsonData
+   */
+  static inline JsonData ViewOf(const Json::Value& value, const std::shared_ptr<const Json::Value>& owner,
+                                ValidationContext* context)
+  {
+    JsonData view = JsonData::View(value, owner);
+    view._context = context;
+    return view;
+  }
+
+  /**
+   * @brief Make a view of the nested value at the reader, for binding a
+   *        nested object straight from text.
+   * @return JsonData
+   */
+  inline JsonData TextView(JsonReader& reader) const
+  {
+    JsonData view(&reader);
+    view._nested = true;
+    view._context = _context;
+    return view;
+  }
+
+  /**
+   * @brief Get the value being bound: the retained tree, or while a released
+   *        object is being constructed, the source data.
+   * @throws std::logic_error if the object has released its document, so
+   *         there is nothing left to bind from.
+   * @return const Json::Value&
+   */
+  inline const Json::Value& Source() const
+  {
+    if (_root) {
+      return *_root;
+    }
+    if (!_source) {
+      throw std::logic_error("document released");
+    }
+    return _source->Source();
+  }
+
+  /**
+   * @brief Forget the source data and error collector, which are only valid
+   *        during construction. Called by the data as it is destroyed, and by
+   *        Validate() once it has its result.
+   * @return None
+   */
+  inline void Detach()
+  {
+    _source = nullptr;
+    _context = nullptr;
+  }
+
+  /**
+   * @brief Get the reader to bind from when binding straight from text.
+   * @return JsonReader*, or nullptr when binding from a tree.
+   */
+  inline JsonReader* Reader() const
+  {
+    return _source ? _source->Reader() : nullptr;
+  }
+
+  /**
+   * @brief Get the handle of the tree owning Source(), for nested views.
+   * @return const std::shared_ptr<const Json::Value>&
+   */
+  inline const std::shared_ptr<const Json::Value>& Owner() const
+  {
+    if (_root || !_source) {
+      return _root;
+    }
+    return _source->_view ? *_source->_owner : _source->_root;
+  }
+
+  /**
+   * @brief Bind a member of the object by name. From text only that member
+   *        is read; the others are skipped without being parsed.
+   * @param key Member name.
+   * @param value Reference to store the parsed value.
+   * @return false if the object has no such member.
+   */
+  template<typename T>
+  bool BindMember(const std::string& key, T& value) const
+  {
+    if (_source && _source->ScanMembers()) {
+      JsonReader* reader = _source->MemberReader(key);
+      if (reader) {
+        ParseValue(key, *reader, value);
+      }
+      return reader != nullptr;
+    }
+
+    // A value which is not an object has no members, as in BindFields()
+    const Json::Value& object = Source();
+    const Json::Value* member = object.isObject() ? object.find(key.data(), key.data() + key.size()) : nullptr;
+    if (member) {
+      ParseValue(key, *member, value);
+    }
+    return member != nullptr;
+  }
+
+  /**
+   * @brief Bind the fields of C from the object being bound. Fields are bound,
+   *        and their errors reported, in declaration order whatever the order
+   *        of the members, so that the tree and the text agree.
+   */
+  template<typename C, size_t... I>
+  void BindFields(C& self, std::index_sequence<I...> fields) const
+  {
+    if (JsonReader* reader = Reader()) {
+      BindFields(*reader, self, fields);
+      return;
+    }
+
+    std::array<const Json::Value*, sizeof...(I)> values{};
+    const Json::Value& object = Source();
+    if (Stopped()) {
+      return;
+    }
+    if (object.isObject()) {
+      for (auto it = object.begin(); it != object.end(); ++it) {
+        const char* end;
+        const char* name = it.memberName(&end);
+        int index = FieldIndex<C>::Find(name, end - name);
+        if (index >= 0) {
+          values[index] = &*it;
+        }
+      }
+    }
+
+    (BindValue<C, I>(self, values[I]), ...);
+  }
+
+  /**
+   * @brief Bind the fields of C from the object at the reader. The members
+   *        are skipped over first, keeping the position of the last one for
+   *        each field, as a tree keeps the last duplicate. The fields are then
+   *        read from those positions in declaration order, through a copy of
+   *        the reader. Their values are only checked then, so the first pass
+   *        skips them by matching brackets; every other member, including a
+   *        duplicate which is passed over, is checked as it is skipped.
+   */
+  template<typename C, size_t... I>
+  void BindFields(JsonReader& reader, C& self, std::index_sequence<I...>) const
+  {
+    std::array<const char*, sizeof...(I)> positions{};
+    std::optional<JsonReader> memberReader;
+    _source->_consumed = true;
+    if (Stopped()) {
+      return;
+    }
+    if (reader.Peek() == JsonToken::Object) {
+      std::string_view name;
+      reader.BeginObject();
+      while (reader.NextMember(name)) {
+        int index = FieldIndex<C>::Find(name.data(), name.size());
+        if (index < 0) {
+          reader.Skip();
+          continue;
+        }
+        if (positions[index]) {
+          if (reader.GetSettings().rejectDuplicateKeys) {
+            reader.Error("Duplicate key: '" + std::string(name) + "'");
+          }
+          // The earlier duplicate is never read, so check it now
+          memberReader->Seek(positions[index]);
+          memberReader->Skip();
+        }
+        if (!memberReader) {
+          memberReader.emplace(reader);
+        }
+        positions[index] = reader.Position();
+        reader.SkipUnchecked();
+      }
+    } else {
+      reader.Skip();
+    }
+    if (!_source->_nested) {
+      reader.Finish();
+    }
+
+    (ReadMember<C, I>(self, memberReader ? &*memberReader : nullptr, positions[I]), ...);
+  }
+
+  /**
+   * @brief Bind a field from its member in a tree, or if it has none, apply
+   *        its default or report it missing.
+   */
+  template<typename C, size_t I>
+  void BindValue(C& self, const Json::Value* value) const
+  {
+    if (!value) {
+      BindMissing<C, I>(self, false);
+    } else if (!Stopped()) {
+      BindField<C, I>(*this, self, *value);
+    }
+  }
+
+  /**
+   * @brief Bind a field from its member at position, or if it has none,
+   *        apply its default or report it missing.
+   */
+  template<typename C, size_t I>
+  void ReadMember(C& self, JsonReader* reader, const char* position) const
+  {
+    if (!position) {
+      BindMissing<C, I>(self, false);
+    } else if (!Stopped()) {
+      reader->Seek(position);
+      ReadField<C, I>(*this, self, *reader);
+    }
+  }
+
+  template<typename C, size_t I>
+  static void ReadField(const ValidatedJson& binder, C& self, JsonReader& reader)
+  {
+    constexpr auto field = C::Fields().template Get<I>();
+    constexpr std::string_view key(field.key, field.length);
+    ValidationContext::Scope scope(binder._context, key);
+    binder.ParseValue(key, reader, self.*field.member);
+  }
+
+  template<typename C, size_t I>
+  static void BindField(const ValidatedJson& binder, C& self, const Json::Value& value)
+  {
+    constexpr auto field = C::Fields().template Get<I>();
+    constexpr std::string_view key(field.key, field.length);
+    ValidationContext::Scope scope(binder._context, key);
+    binder.ParseValue(key, value, self.*field.member);
+  }
+
+  template<typename C, size_t I>
+  void BindMissing(C& self, bool seen) const
+  {
+    constexpr auto field = C::Fields().template Get<I>();
+    if (seen || Stopped()) {
+      return;
+    }
+    if constexpr (field.kRequired) {
+      ValidationContext::Scope scope(_context, std::string_view(field.key, field.length));
+      Fail("Required key \"" + std::string(field.key) + "\" not found");
+    } else {
+      self.*field.member = field.defaultValue;
+    }
+  }
+
+  /**
+   * @brief Parse the value of a key from the JSON data.
+   *        On failure the error is reported with Fail() and value is left
+   *        unchanged.
+   * @param key Key name to parse, used in error messages.
+   * @param value JSON value to parse.
+   * @param out Reference to store the parsed value of type T.
+   * @return None
+   */
+  template<typename T>
+  void ParseValue(std::string_view key, const Json::Value& value, T& out) const
+  {
+    // Add types here as necessary
+    if constexpr (std::is_same_v<T, std::string>) {
+      if (!value.isString()) {
+        Fail("Expected string value for key: " + std::string(key));
+        return;
+      }
+      out = value.asString();
+    } else if constexpr (is_json_number<T>::value) {
+      if (!ConvertNumber(value, out)) {
+        Fail(ExpectedNumber<T>(key));
+      }
+    } else if constexpr (std::is_same_v<T, bool>) {
+      if (!value.isBool()) {
+        Fail("Expected boolean value for key: " + std::string(key));
+        return;
+      }
+      out = value.asBool();
+    } else if constexpr (std::is_base_of_v<ValidatedJson, T>) {
+      // Deal with nested json objects, which view their subtree in our tree
+      // rather than copying it
+      if (ExpectObject(key, value)) {
+        BindNested([&] { out = T(ViewOf(value)); });
+      }
+    } else if constexpr (is_array_sink<T>::value) {
+      ParseSink(key, value, out);
+    } else if constexpr (is_vector<T>::value) {
+      // Deal with JSON arrays
+      ParseArray(key, value, out);
+    } else {
+      static_assert(false && sizeof(T), "Unsupported type for ParseValue()");
+    }
+  }
+
+  /**
+   * @brief Parse a JSON array into a vector, sized up front.
+   *        Arrays of int and double take a tight loop which converts each
+   *        element with a single type check.
+   * @param key Key name to parse, used in error messages.
+   * @param value JSON value to parse.
+   * @param out Reference to store the parsed vector of type T.
+   * @return None
+   */
+  template<typename T>
+  void ParseArray(std::string_view key, const Json::Value& value, T& out) const
+  {
+    using Element = typename T::value_type;
+
+    if (!value.isArray()) {
+      Fail("Expected array for key: " + std::string(key));
+      return;
+    }
+
+    T result;
+    result.reserve(value.size());
+    if constexpr (is_json_number<Element>::value) {
+      for (Json::ArrayIndex i = 0; i < value.size(); i++) {
+        const Json::Value& element = value[i];
+        Element number;
+        if (!ConvertNumber(element, number)) {
+          // Report the error exactly as for a single value; the index is
+          // only pushed on this path so valid arrays don't pay for it
+          ValidationContext::Scope scope(_context, i);
+          number = Element();
+          ParseValue(key, element, number);
+          if (Stopped()) {
+            return;
+          }
+        }
+        result.push_back(number);
+      }
+    } else if constexpr (std::is_base_of_v<ValidatedJson, Element>) {
+      if (ThreadPool* pool = ParallelPool(value.size())) {
+        ParseArrayParallel(key, value, result, *pool);
+        if (Stopped()) {
+          return;
+        }
+      } else {
+        for (Json::ArrayIndex i = 0; i < value.size(); i++) {
+          const Json::Value& element = value[i];
+          ValidationContext::Scope scope(_context, i);
+          if (ExpectObject(key, element)) {
+            BindNested([&] { result.emplace_back(ViewOf(element)); });
+          }
+          if (Stopped()) {
+            return;
+          }
+        }
+      }
+    } else {
+      for (Json::ArrayIndex i = 0; i < value.size(); i++) {
+        const Json::Value& element = value[i];
+        ValidationContext::Scope scope(_context, i);
+        Element parsed{};
+        ParseValue(key, element, parsed);
+        if (Stopped()) {
+          return;
+        }
+        result.push_back(std::move(parsed));
+      }
+    }
+    out = std::move(result);
+  }
+
+  /**
+   * @brief Bind the nested objects of a large JSON array on the threads of a
+   *        pool, see SetParallelArrays(). The array is split into ranges of
+   *        elements, each bound with a context forked from ours, whose errors
+   *        are then merged in index order. Once a range stops at an error the
+   *        ranges after it are skipped, and it is the lowest such range whose
+   *        errors, or exception, come out, just as binding in order would.
+   * @param key Key name to parse, used in error messages.
+   * @param value JSON array to parse.
+   * @param out Vector to append the bound elements to, in order.
+   * @param pool Threads to bind on.
+   * @throws The exception of the first element to throw, as without a pool.
+   * @return None
+   */
+  template<typename T>
+  void ParseArrayParallel(std::string_view key, const Json::Value& value, T& out, ThreadPool& pool) const
+  {
+    using Element = typename T::value_type;
+
+    const size_t count = value.size();
+    const size_t grain = std::max<size_t>(1, count / (pool.Size() * size_t(8)));
+    const size_t ranges = (count + grain - 1) / grain;
+    const std::shared_ptr<const Json::Value>& owner = Owner();
+
+    // Pre-sized, so each range binds into its own slots
+    std::vector<std::optional<Element>> bound(count);
+    std::vector<std::optional<ValidationContext>> contexts(ranges);
+    std::vector<std::exception_ptr> exceptions(ranges);
+    std::atomic<size_t> stopped{ranges};
+
+    pool.Run(ranges, [&](size_t range) {
+      if (range > stopped.load(std::memory_order_relaxed)) {
+        // Only reached after an earlier range has stopped binding
+        return;
+      }
+      ValidationContext* context = _context ? &contexts[range].emplace(_context->Fork()) : nullptr;
+      size_t end = std::min(count, (range + 1) * grain);
+      try {
+        for (size_t i = range * grain; i < end; i++) {
+          const Json::Value& element = value[static_cast<Json::ArrayIndex>(i)];
+          ValidationContext::Scope scope(context, i);
+          if (!element.isObject()) {
+            Report(context, "Expected JSON object for key: " + std::string(key));
+          } else {
+            BindNested(context, [&] { bound[i].emplace(ViewOf(element, owner, context)); });
+          }
+          if (context && context->Stopped()) {
+            break;
+          }
+        }
+      } catch (...) {
+        exceptions[range] = std::current_exception();
+      }
+      if (exceptions[range] || (context && context->Stopped())) {
+        size_t lowest = stopped.load();
+        while (range < lowest && !stopped.compare_exchange_weak(lowest, range)) {
+        }
+      }
+    });
+
+    for (size_t range = 0; range < ranges; range++) {
+      if (contexts[range]) {
+        _context->Merge(std::move(*contexts[range]));
+      }
+      if (exceptions[range]) {
+        std::rethrow_exception(exceptions[range]);
+      }
+      if (Stopped()) {
+        return;
+      }
+    }
+    for (std::optional<Element>& element : bound) {
+      if (element) {
+        out.push_back(std::move(*element));
+      }
+    }
+  }
+
+  /**
+   * @brief Hand each element of a JSON array to a sink, checking it as for
+   *        ParseArray().
+   * @param key Key name to parse, used in error messages.
+   * @param value JSON value to parse.
+   * @param out Sink to hand the elements to.
+   * @return None
+   */
+  template<typename T>
+  void ParseSink(std::string_view key, const Json::Value& value, JsonArraySink<T>& out) const
+  {
+    if (!value.isArray()) {
+      Fail("Expected array for key: " + std::string(key));
+      return;
+    }
+
+    for (Json::ArrayIndex i = 0; i < value.size(); i++) {
+      const Json::Value& element = value[i];
+      if constexpr (is_json_number<T>::value) {
+        T number;
+        if (ConvertNumber(element, number)) {
+          out.Push(std::move(number));
+          continue;
+        }
+        ValidationContext::Scope scope(_context, i);
+        ParseValue(key, element, number);
+      } else {
+        ValidationContext::Scope scope(_context, i);
+        size_t errors = ErrorCount();
+        std::optional<T> parsed;
+        if constexpr (std::is_base_of_v<ValidatedJson, T>) {
+          if (ExpectObject(key, element)) {
+            BindNested([&] { parsed.emplace(ViewOf(element)); });
+          }
+        } else {
+          parsed.emplace();
+          ParseValue(key, element, *parsed);
+        }
+        if (parsed && ErrorCount() == errors) {
+          out.Push(std::move(*parsed));
+        }
+      }
+      if (Stopped()) {
+        return;
+      }
+    }
+  }
+
+  /**
+   * @brief Read the value of a key straight from JSON text, with the same
+   *        checks and errors as when parsing it from a tree. A value of the
+   *        wrong type is reported and skipped.
+   * @param key Key name to parse, used in error messages.
+   * @param reader Reader positioned at the value.
+   * @param out Reference to store the parsed value of type T.
+   * @return None
+   */
+  template<typename T>
+  void ParseValue(std::string_view key, JsonReader& reader, T& out) const
+  {
+    JsonToken token = reader.Peek();
+    if constexpr (std::is_same_v<T, std::string>) {
+      if (token != JsonToken::String) {
+        Mismatch("Expected string value for key: " + std::string(key), reader);
+        return;
+      }
+      out.assign(reader.ReadString());
+    } else if constexpr (is_json_number<T>::value) {
+      if (token != JsonToken::Number || !ConvertNumber(reader.ReadNumber(), out)) {
+        Mismatch(ExpectedNumber<T>(key), reader, token == JsonToken::Number);
+      }
+    } else if constexpr (std::is_same_v<T, bool>) {
+      if (token != JsonToken::True && token != JsonToken::False) {
+        Mismatch("Expected boolean value for key: " + std::string(key), reader);
+        return;
+      }
+      out = reader.ReadBool();
+    } else if constexpr (std::is_base_of_v<ValidatedJson, T>) {
+      if (token != JsonToken::Object) {
+        Mismatch("Expected JSON object for key: " + std::string(key), reader);
+        return;
+      }
+      ReadNested(reader, [&](JsonData&& view) { out = T(std::move(view)); });
+    } else if constexpr (is_array_sink<T>::value) {
+      ParseSink(key, reader, out);
+    } else if constexpr (is_vector<T>::value) {
+      ParseArray(key, reader, out);
+    } else {
+      static_assert(false && sizeof(T), "Unsupported type for ParseValue()");
+    }
+  }
+
+  /**
+   * @brief Read a JSON array straight from JSON text into a vector.
+   * @param key Key name to parse, used in error messages.
+   * @param reader Reader positioned at the array.
+   * @param out Reference to store the parsed vector of type T.
+   * @return None
+   */
+  template<typename T>
+  void ParseArray(std::string_view key, JsonReader& reader, T& out) const
+  {
+    using Element = typename T::value_type;
+
+    if (reader.Peek() != JsonToken::Array) {
+      Mismatch("Expected array for key: " + std::string(key), reader);
+      return;
+    }
+
+    T result;
+    reader.BeginArray();
+    for (size_t i = 0; reader.NextElement(); i++) {
+      if constexpr (is_json_number<Element>::value) {
+        // Numbers are converted as they are read; as for a tree, the index
+        // is only pushed to report a failure
+        JsonToken token = reader.Peek();
+        Element number;
+        if (token == JsonToken::Number && ConvertNumber(reader.ReadNumber(), number)) {
+          result.push_back(number);
+          continue;
+        }
+        ValidationContext::Scope scope(_context, i);
+        Mismatch(ExpectedNumber<Element>(key), reader, token == JsonToken::Number);
+        result.push_back(Element());
+      } else if constexpr (std::is_base_of_v<ValidatedJson, Element>) {
+        ValidationContext::Scope scope(_context, i);
+        if (reader.Peek() != JsonToken::Object) {
+          Mismatch("Expected JSON object for key: " + std::string(key), reader);
+        } else {
+          ReadNested(reader, [&](JsonData&& view) { result.emplace_back(std::move(view)); });
+        }
+      } else {
+        ValidationContext::Scope scope(_context, i);
+        Element element{};
+        ParseValue(key, reader, element);
+        result.push_back(std::move(element));
+      }
+      if (Stopped()) {
+        return;
+      }
+    }
+    out = std::move(result);
+  }
+
+  /**
+   * @brief Read a JSON array straight from JSON text, handing each element to
+   *        a sink as soon as it is read.
+   * @param key Key name to parse, used in error messages.
+   * @param reader Reader positioned at the array.
+   * @param out Sink to hand the elements to.
+   * @return None
+   */
+  template<typename T>
+  void ParseSink(std::string_view key, JsonReader& reader, JsonArraySink<T>& out) const
+  {
+    if (reader.Peek() != JsonToken::Array) {
+      Mismatch("Expected array for key: " + std::string(key), reader);
+      return;
+    }
+
+    reader.BeginArray();
+    for (size_t i = 0; reader.NextElement(); i++) {
+      if constexpr (is_json_number<T>::value) {
+        JsonToken token = reader.Peek();
+        T number;
+        if (token == JsonToken::Number && ConvertNumber(reader.ReadNumber(), number)) {
+          out.Push(std::move(number));
+          continue;
+        }
+        ValidationContext::Scope scope(_context, i);
+        Mismatch(ExpectedNumber<T>(key), reader, token == JsonToken::Number);
+      } else {
+        ValidationContext::Scope scope(_context, i);
+        size_t errors = ErrorCount();
+        std::optional<T> parsed;
+        if constexpr (std::is_base_of_v<ValidatedJson, T>) {
+          if (reader.Peek() != JsonToken::Object) {
+            Mismatch("Expected JSON object for key: " + std::string(key), reader);
+          } else {
+            ReadNested(reader, [&](JsonData&& view) { parsed.emplace(std::move(view)); });
+          }
+        } else {
+          parsed.emplace();
+          ParseValue(key, reader, *parsed);
+        }
+        if (parsed && ErrorCount() == errors) {
+          out.Push(std::move(*parsed));
+        }
+      }
+      if (Stopped()) {
+        return;
+      }
+    }
+  }
+
+  /**
+   * @brief Construct a nested object from the object at the reader, and skip
+   *        whatever of the object its constructor didn't read.
+   * @param construct Function constructing the object from a JsonData.
+   * @return None
+   */
+  template<typename F>
+  void ReadNested(JsonReader& reader, F&& construct) const
+  {
+    JsonData view = TextView(reader);
+    BindNested([&] { construct(std::move(view)); });
+    if (!view._consumed && !Stopped()) {
+      reader.Skip();
+    }
+  }
+
+  /**
+   * @brief Report a value of the wrong type and skip it, so that the reader
+   *        is ready for the next value if binding carries on.
+   * @param message Description of the failure.
+   * @param read Whether the value has already been read.
+   * @return None
+   */
+  inline void Mismatch(const std::string& message, JsonReader& reader, bool read = false) const
+  {
+    Fail(message);
+    if (!read && !Stopped()) {
+      reader.Skip();
+    }
+  }
+
+  /**
+   * @brief Bind a nested object. Under Validate(), an exception thrown by a
+   *        check in its constructor is reported at its path, and binding
+   *        carries on with the rest of the document.
+   * @param bind Function constructing the nested object.
+   * @return None
+   */
+  template<typename F>
+  void BindNested(F&& bind) const
+  {
+    BindNested(_context, std::forward<F>(bind));
+  }
+
+  /**
+   * @brief Bind a nested object as above, reporting to the given context.
+   * @param context Context to report to, or nullptr to throw.
+   * @param bind Function constructing the nested object.
+   * @return None
+   */
+  template<typename F>
+  static void BindNested(ValidationContext* context, F&& bind)
+  {
+    if (!context) {
+      bind();
+      return;
+    }
+    try {
+      bind();
+    } catch (const JsonSyntaxError&) {
+      // Binding can't carry on past invalid JSON
+      throw;
+    } catch (const std::runtime_error& e) {
+      context->Report(e.what());
+    }
+  }
+
+  /**
+   * @brief Check that a value is an object, reporting a failure if not.
+   * @return bool
+   */
+  inline bool ExpectObject(std::string_view key, const Json::Value& value) const
+  {
+    if (!value.isObject()) {
+      Fail("Expected JSON object for key: " + std::string(key));
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Describe a value which is not a number of type T.
+   * @return std::string
+   */
+  template<typename T>
+  static std::string ExpectedNumber(std::string_view key)
+  {
+    if constexpr (std::is_same_v<T, double>) {
+      return "Expected double value for key: " + std::string(key);
+    } else if constexpr (std::is_same_v<T, int>) {
+      return "Expected integer value for key: " + std::string(key);
+    } else {
+      return "Expected integer value from " + std::to_string(std::numeric_limits<T>::min()) + " to " +
+             std::to_string(std::numeric_limits<T>::max()) + " for key: " + std::string(key);
+    }
+  }
+
+  /**
+   * @brief Convert a JSON number to an integer type with one type check and
+   *        one range check. Integers are never converted by way of double.
+   *        Accepts integers in the range of T and whole doubles in it, the
+   *        same values as Json::Value::isInt() for int.
+   * @return false if the value is not an integer in the range of T, in
+   *         which case number is left unchanged.
+   */
+  template<typename T>
+  static inline std::enable_if_t<is_json_integer<T>::value, bool> ConvertNumber(const Json::Value& value,
+                                                                                T& number)
+  {
+    switch (value.type()) {
+      case Json::intValue:
+        return FitInteger(static_cast<int64_t>(value.asLargestInt()), number);
+      case Json::uintValue:
+        return FitInteger(static_cast<uint64_t>(value.asLargestUInt()), number);
+      case Json::realValue:
+        return FitWhole(value.asDouble(), number);
+      default:
+        return false;
+    }
+  }
+
+  /**
+   * @brief Convert a JSON number to double with one type check. Accepts the
+   *        same values as Json::Value::isDouble().
+   * @return false if the value is not a number.
+   */
+  static inline bool ConvertNumber(const Json::Value& value, double& number)
+  {
+    switch (value.type()) {
+      case Json::intValue:
+      case Json::uintValue:
+      case Json::realValue:
+        number = value.asDouble();
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /**
+   * @brief Convert a number read from text to an integer type, accepting the
+   *        same values as for a tree: integers in range and whole doubles.
+   * @return false if the number is not in the range of T, in which case
+   *         number is left unchanged.
+   */
+  template<typename T>
+  static inline std::enable_if_t<is_json_integer<T>::value, bool> ConvertNumber(const JsonNumber& value,
+                                                                                T& number)
+  {
+    if (!value.integer) {
+      return FitWhole(value.real, number);
+    }
+    if (!value.negative) {
+      return FitInteger(value.magnitude, number);
+    }
+    // Magnitude of the lowest value of T, which for unsigned T leaves only -0
+    uint64_t limit = std::is_signed_v<T> ? static_cast<uint64_t>(std::numeric_limits<T>::max()) + 1 : 0;
+    if (value.magnitude > limit) {
+      return false;
+    }
+    number = static_cast<T>(0 - value.magnitude);
+    return true;
+  }
+
+  /**
+   * @brief Store a signed integer in number if it is in the range of T.
+   * @return false if it is out of range, leaving number unchanged.
+   */
+  template<typename T>
+  static inline bool FitInteger(int64_t n, T& number)
+  {
+    T converted = static_cast<T>(n);
+    bool fits;
+    if constexpr (std::is_signed_v<T>) {
+      fits = static_cast<int64_t>(converted) == n;
+    } else {
+      fits = n >= 0 && static_cast<uint64_t>(n) <= static_cast<uint64_t>(std::numeric_limits<T>::max());
+    }
+    if (fits) {
+      number = converted;
+    }
+    return fits;
+  }
+
+  /**
+   * @brief Store an unsigned integer in number if it is in the range of T.
+   * @return false if it is out of range, leaving number unchanged.
+   */
+  template<typename T>
+  static inline bool FitInteger(uint64_t n, T& number)
+  {
+    if (n > static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+      return false;
+    }
+    number = static_cast<T>(n);
+    return true;
+  }
+
+  /**
+   * @brief Store a double in number if it is a whole number in the range of T.
+   * @return false if it is not, leaving number unchanged.
+   */
+  template<typename T>
+  static inline bool FitWhole(double real, T& number)
+  {
+    // Both bounds are exact as doubles: the lowest value of T is zero or a
+    // power of two, and so is one past the highest. NaN fails either test.
+    if (!(real >= static_cast<double>(std::numeric_limits<T>::min()) &&
+          real < static_cast<double>(std::numeric_limits<T>::max()) + 1.0)) {
+      return false;
+    }
+    T converted = static_cast<T>(real);
+    if (static_cast<double>(converted) != real) {
+      return false;
+    }
+    number = converted;
+    return true;
+  }
+
+  /**
+   * @brief Convert a number read from text to double.
+   * @return true
+   */
+  static inline bool ConvertNumber(const JsonNumber& value, double& number)
+  {
+    number = value.real;
+    return true;
+  }
+
+protected:
+  std::shared_ptr<const Json::Value> _root;
+
+private:
+  // Data the object is being constructed from; cleared by the data as it is
+  // destroyed, see JsonData::Binding
+  const JsonData* _source = nullptr;
+
+  // Error collector of an object bound by Validate(), valid only during
+  // construction
+  ValidationContext* _context = nullptr;
+
+  // See SetParallelArrays()
+  static std::atomic<size_t> _parallelThreshold;
+  static std::atomic<ThreadPool*> _parallelPool;
+
+  friend class JsonData;
+};
+
+inline void JsonData::Binding::Attach(ValidatedJson* object)
+{
+  Detach();
+  _object = object;
+}
+
+inline void JsonData::Binding::Detach()
+{
+  if (_object) {
+    _object->Detach();
+    _object = nullptr;
+  }
+}
+
+/**
+ * @brief Construct T from JSON data without throwing on validation errors.
+ *        T is bound through the same constructor and field declarations as
+ *        when it is constructed directly, but failures are collected rather
+ *        than thrown, each with the JSON Pointer path of the offending value.
+ *        Exceptions thrown by checks in the constructor of T are caught and
+ *        reported as well.
+ * @param data JsonData object containing the parsed JSON data.
+ * @param mode Whether to stop at the first error or collect all of them.
+ * @param args Further arguments to the constructor of T, such as the
+ *        callback of a JsonArraySink.
+ * @return ValidationResult<T> holding either the object or its errors.
+ */
+template<typename T, typename... Args>
+ValidationResult<T> Validate(JsonData&& data, ValidationMode mode, Args&&... args)
+{
+  ValidationContext context(mode);
+  data._context = &context;
+
+  std::optional<T> value;
+  try {
+    value.emplace(std::move(data), std::forward<Args>(args)...);
+  } catch (const std::runtime_error& e) {
+    context.Report(e.what());
+  }
+  // The context goes out of scope before the data
+  data._binding.Detach();
+
+  if (context.Failed()) {
+    return ValidationResult<T>(context.TakeErrors());
+  }
+  return ValidationResult<T>(std::move(*value));
+}
+
+/**
+ * @brief Parse and construct T from JSON text without throwing.
+ *        Parse errors are returned in the result like validation errors.
+ * @param text The JSON text.
+ * @param mode Whether to stop at the first error or collect all of them.
+ * @param parser Parser to use, by default the calling thread's parser.
+ * @return ValidationResult<T> holding either the object or its errors.
+ */
+template<typename T>
+ValidationResult<T> Validate(std::string_view text, ValidationMode mode = ValidationMode::FirstError,
+                             JsonParser& parser = JsonParser::ThreadLocal())
+{
+  Json::Value root;
+  std::string errors;
+  if (!parser.Parse(text.data(), text.data() + text.size(), root, errors)) {
+    return ValidationResult<T>(ValidationErrors{ValidationError{"JSON parsing error: " + errors, ""}});
+  }
+  return Validate<T>(JsonData(std::move(root)), mode);
+}
+
+/**
+ * @brief Construct T straight from JSON text, as from JsonText, without
+ *        throwing. Syntax errors are returned in the result like validation
+ *        errors.
+ * @param text The JSON text, which must outlive binding.
+ * @param mode Whether to stop at the first error or collect all of them.
+ * @param parser Parser whose settings to read with, by default the calling
+ *        thread's parser.
+ * @return ValidationResult<T> holding either the object or its errors.
+ */
+template<typename T>
+ValidationResult<T> ValidateText(std::string_view text, ValidationMode mode = ValidationMode::FirstError,
+                                 JsonParser& parser = JsonParser::ThreadLocal())
+{
+  return ValidateText<T>(text, mode, parser.GetSettings());
+}
+
+/**
+ * @brief Construct T straight from JSON text, as from JsonText, without
+ *        throwing. Only reads settings, so any number of threads may share
+ *        them.
+ * @param text The JSON text, which must outlive binding.
+ * @param mode Whether to stop at the first error or collect all of them.
+ * @param settings Settings to read with.
+ * @return ValidationResult<T> holding either the object or its errors.
+ */
+template<typename T>
+ValidationResult<T> ValidateText(std::string_view text, ValidationMode mode, const JsonParserSettings& settings)
+{
+  JsonTextBuffers buffers;
+  return ValidateText<T>(text, mode, settings, buffers);
+}
+
+/**
+ * @brief Construct T straight from JSON text, as from JsonText, without
+ *        throwing, reading in buffers kept from earlier texts.
+ * @param text The JSON text, which must outlive binding.
+ * @param mode Whether to stop at the first error or collect all of them.
+ * @param settings Settings to read with.
+ * @param buffers Buffers to read in, used by nothing else meanwhile.
+ * @return ValidationResult<T> holding either the object or its errors.
+ */
+template<typename T>
+ValidationResult<T> ValidateText(std::string_view text, ValidationMode mode, const JsonParserSettings& settings,
+                                 JsonTextBuffers& buffers)
+{
+  try {
+    return Validate<T>(JsonText(text, settings, buffers), mode);
+  } catch (const JsonSyntaxError& e) {
+    // Text rejected before binding starts, such as invalid UTF-8
+    return ValidationResult<T>(ValidationErrors{ValidationError{e.what(), ""}});
+  }
+}
 
 #endif // VALIDATED_JSON_H
@@ -0,0 +1,276 @@
+#ifndef VALIDATION_RESULT_H
+#define VALIDATION_RESULT_H
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Error found while validating JSON data.
+ */
+struct ValidationError
+{
+  std::string message;
+  // JSON Pointer (RFC 6901) to the offending value, e.g. "/nested/age";
+  // empty for the document itself
+  std::string path;
+};
+
+using ValidationErrors = std::vector<ValidationError>;
+
+/**
+ * @brief How many errors Validate() looks for.
+ */
+enum class ValidationMode
+{
+  // Stop binding at the first error
+  FirstError,
+  // Keep binding after an error and report every one
+  AllErrors
+};
+
+/**
+ * @brief Collects the errors found while binding, in place of exceptions.
+ *        Created by Validate() and handed down to every object it binds.
+ *        The location being bound is kept as a stack of keys and indexes,
+ *        which is only turned into a path string when an error is reported.
+ * @see   Validate, ValidatedJson
+ */
+class ValidationContext
+{
+public:
+  /**
+   * @brief Pushes a key or array index onto the path for its lifetime.
+   *        Does nothing without a context, i.e. when binding throws.
+   */
+  class Scope
+  {
+  public:
+    inline Scope(ValidationContext* context, std::string_view key) :
+      _context(context)
+    {
+      if (_context) {
+        _context->Push(Segment{key.data(), key.size()});
+      }
+    }
+
+    inline Scope(ValidationContext* context, size_t index) :
+      _context(context)
+    {
+      if (_context) {
+        _context->Push(Segment{nullptr, index});
+      }
+    }
+
+    inline ~Scope()
+    {
+      if (_context) {
+        _context->Pop();
+      }
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    ValidationContext* _context;
+  };
+
+  explicit ValidationContext(ValidationMode mode = ValidationMode::FirstError) :
+    _mode(mode)
+  {}
+
+  /**
+   * @brief Record an error at the current path.
+   * @param message Description of the error.
+   */
+  void Report(std::string message)
+  {
+    _errors.push_back(ValidationError{std::move(message), Path()});
+  }
+
+  /**
+   * @brief Whether binding should stop: after the first error, unless all
+   *        errors are being collected.
+   * @return bool
+   */
+  inline bool Stopped() const
+  {
+    return _mode == ValidationMode::FirstError && !_errors.empty();
+  }
+
+  /**
+   * @brief Whether any error has been recorded.
+   * @return bool
+   */
+  inline bool Failed() const { return !_errors.empty(); }
+
+  /**
+   * @brief Get the number of errors recorded so far.
+   * @return size_t
+   */
+  inline size_t ErrorCount() const { return _errors.size(); }
+
+  /**
+   * @brief Take the recorded errors.
+   * @return ValidationErrors
+   */
+  inline ValidationErrors TakeErrors() { return std::move(_errors); }
+
+  /**
+   * @brief Make a context with the same mode and current path but no errors,
+   *        for binding part of the value at that path on another thread.
+   *        The keys on the path must outlive the copy.
+   * @return ValidationContext
+   * @see   Merge
+   */
+  ValidationContext Fork() const
+  {
+    ValidationContext fork(_mode);
+    std::copy(_path, _path + std::min(_depth, kInlineDepth), fork._path);
+    fork._depth = _depth;
+    fork._deepPath = _deepPath;
+    return fork;
+  }
+
+  /**
+   * @brief Append the errors of a context made by Fork() to those recorded here.
+   * @param other The forked context.
+   */
+  void Merge(ValidationContext&& other)
+  {
+    for (ValidationError& error : other._errors) {
+      _errors.push_back(std::move(error));
+    }
+    other._errors.clear();
+  }
+
+private:
+  // Key, or array index when key is null
+  struct Segment
+  {
+    const char* key;
+    size_t length;
+  };
+
+  // Path depth held without allocating; deeper segments spill to the heap
+  static constexpr size_t kInlineDepth = 32;
+
+  inline void Push(Segment segment)
+  {
+    if (_depth < kInlineDepth) {
+      _path[_depth] = segment;
+    } else {
+      _deepPath.push_back(segment);
+    }
+    _depth++;
+  }
+
+  inline void Pop()
+  {
+    if (--_depth >= kInlineDepth) {
+      _deepPath.pop_back();
+    }
+  }
+
+  /**
+   * @brief Format the current path as a JSON Pointer.
+   * @return std::string
+   */
+  std::string Path() const
+  {
+    std::string path;
+    for (size_t depth = 0; depth < _depth; depth++) {
+      const Segment& segment = depth < kInlineDepth ? _path[depth] : _deepPath[depth - kInlineDepth];
+      path += '/';
+      if (!segment.key) {
+        path += std::to_string(segment.length);
+        continue;
+      }
+      for (size_t i = 0; i < segment.length; i++) {
+        char c = segment.key[i];
+        if (c == '~') {
+          path += "~0";
+        } else if (c == '/') {
+          path += "~1";
+        } else {
+          path += c;
+        }
+      }
+    }
+    return path;
+  }
+
+  ValidationMode _mode;
+  Segment _path[kInlineDepth];
+  size_t _depth = 0;
+  std::vector<Segment> _deepPath;
+  ValidationErrors _errors;
+};
+
+/**
+ * @brief Result of validating JSON data without exceptions: either a bound
+ *        object or the errors which prevented it from being bound.
+ * @see   Validate
+ */
+template<typename T>
+class ValidationResult
+{
+public:
+  /**
+   * @brief Construct a successful result.
+   * @param value The bound object.
+   */
+  explicit ValidationResult(T&& value) :
+    _value(std::move(value))
+  {}
+
+  /**
+   * @brief Construct a failed result.
+   * @param errors The errors which prevented binding.
+   */
+  explicit ValidationResult(ValidationErrors&& errors) :
+    _errors(std::move(errors))
+  {}
+
+  /**
+   * @brief Whether validation succeeded.
+   * @return bool
+   */
+  inline bool Ok() const { return _value.has_value(); }
+  inline explicit operator bool() const { return Ok(); }
+
+  /**
+   * @brief Get the bound object.
+   * @throws std::logic_error if validation failed.
+   * @return T&
+   */
+  inline T& Value()
+  {
+    if (!_value) {
+      throw std::logic_error("ValidationResult holds no value");
+    }
+    return *_value;
+  }
+
+  inline const T& Value() const
+  {
+    return const_cast<ValidationResult*>(this)->Value();
+  }
+
+  /**
+   * @brief Get the errors which prevented binding.
+   * @return const ValidationErrors& (empty if validation succeeded)
+   */
+  inline const ValidationErrors& Errors() const { return _errors; }
+
+private:
+  std::optional<T> _value;
+  ValidationErrors _errors;
+};
+
+#endif // VALIDATION_RESULT_H
@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Bench.h"
+#include "MyData.h"
+#include "ThreadPool.h"
+
+// One array of 262144 small objects in a tree, bound in order and split
+// across 2 to N threads by SetParallelArrays(). Only binding is timed; the
+// tree is parsed once and shared.
+
+namespace
+{
+class BenchItems : public ValidatedJson
+{
+public:
+  BenchItems(JsonData&& data) :
+    ValidatedJson(std::move(data))
+  {
+    Required("items", _items);
+  }
+
+  size_t Size() const { return _items.size(); }
+
+private:
+  std::vector<MyData2> _items;
+};
+}
+
+void RunArrayBench()
+{
+  std::string json = "{\"items\": [";
+  for (size_t i = 0; i < 262144; i++) {
+    json += (i ? ", {\"age\": " : "{\"age\": ") + std::to_string(i % 100) + "}";
+  }
+  json += "]}";
+  std::shared_ptr<const Json::Value> tree = JsonString(json).GetSnapshot();
+
+  BenchPrint("vector<MyData2> in order", BenchRun(5, [&] {
+    BenchItems items{JsonData(tree)};
+    BenchKeep(items.Size());
+  }), json.size());
+
+  // Splitting needs more than one thread, which on a single core only
+  // shows the overhead
+  unsigned cores = std::max(2u, std::thread::hardware_concurrency());
+  std::vector<unsigned> counts;
+  for (unsigned threads = 2; threads < cores; threads *= 2) {
+    counts.push_back(threads);
+  }
+  counts.push_back(cores);
+
+  for (unsigned threads : counts) {
+    ThreadPool pool(threads);
+    ValidatedJson::SetParallelArrays(1 << 16, &pool);
+    BenchPrint("vector<MyData2> split, " + std::to_string(threads) + " threads", BenchRun(5, [&] {
+      BenchItems items{JsonData(tree)};
+      BenchKeep(items.Size());
+    }), json.size());
+  }
+  ValidatedJson::SetParallelArrays(0);
+}
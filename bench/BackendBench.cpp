@@ -0,0 +1,69 @@
+#include <string>
+#include <string_view>
+
+#include "Bench.h"
+#include "BenchData.h"
+#include "MyData.h"
+
+// The same documents parsed and bound through each parser backend: number
+// arrays, and records mixing strings, escapes, nesting and literals. Then
+// binding through a tree against binding straight from the text.
+
+namespace
+{
+void Compare(const std::string& name, const std::string& json, size_t iterations)
+{
+  for (JsonBackend backend : {JsonBackend::Jsoncpp, JsonBackend::Builtin}) {
+    JsonParserSettings settings;
+    settings.backend = backend;
+    JsonParser parser(settings);
+    const char* label = backend == JsonBackend::Jsoncpp ? "jsoncpp" : "builtin";
+
+    BenchPrint(name + ", " + label, BenchRun(iterations, [&] {
+      JsonString data{std::string_view(json), parser};
+      BenchKeep(data);
+    }), json.size());
+  }
+}
+}
+
+void RunBackendBench()
+{
+  for (size_t values : {16, 1024, 65536}) {
+    Compare("parse MyData, " + std::to_string(values) + " values", MakeMyData(values),
+            values < 1024 ? 20000 : 2000000 / values);
+  }
+  for (size_t records : {16, 1024}) {
+    Compare("parse records, " + std::to_string(records) + " records", MakeRecords(records),
+            records < 1024 ? 5000 : 50);
+  }
+
+  // Binding is unchanged whichever backend produced the tree
+  const std::string document = MakeMyData(1024);
+  for (JsonBackend backend : {JsonBackend::Jsoncpp, JsonBackend::Builtin}) {
+    JsonParserSettings settings;
+    settings.backend = backend;
+    JsonParser parser(settings);
+    BenchPrint(std::string("parse + bind MyData, 1024 values, ") +
+               (backend == JsonBackend::Jsoncpp ? "jsoncpp" : "builtin"),
+               BenchRun(2000, [&] {
+                 MyData data{JsonString(std::string_view(document), parser)};
+                 BenchKeep(data);
+               }), document.size());
+  }
+
+  for (size_t values : {16, 1024, 65536}) {
+    const std::string json = MakeMyData(values);
+    const size_t iterations = values < 1024 ? 20000 : 2000000 / values;
+    const std::string size = std::to_string(values) + " values";
+
+    BenchPrint("parse + bind MyData, " + size + ", JsonString (tree)", BenchRun(iterations, [&] {
+      MyData data{JsonString(std::string_view(json))};
+      BenchKeep(data);
+    }), json.size());
+    BenchPrint("parse + bind MyData, " + size + ", JsonText (direct)", BenchRun(iterations, [&] {
+      MyData data{JsonText(json)};
+      BenchKeep(data);
+    }), json.size());
+  }
+}
@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "Bench.h"
+#include "BenchData.h"
+#include "MyData.h"
+#include "ValidateBatch.h"
+
+// Many small unrelated documents, one in four invalid, bound one after
+// another on the calling thread and with ValidateBatch() on 1 to N threads.
+
+void RunBatchBench()
+{
+  const BenchDefect defects[] = {BenchDefect::None, BenchDefect::MissingKey, BenchDefect::None,
+                                 BenchDefect::WrongType};
+  std::vector<std::string> texts;
+  size_t bytes = 0;
+  for (size_t i = 0; i < 100000; i++) {
+    texts.push_back(MakeMyData(i % 32, defects[i % 4]));
+    bytes += texts.back().size();
+  }
+  std::vector<std::string_view> documents(texts.begin(), texts.end());
+
+  // Keeps every result, as ValidateBatch() does
+  BenchPrint("ValidateText() in a loop, 1 thread", BenchRun(5, [&] {
+    std::vector<ValidationResult<MyData>> results;
+    results.reserve(documents.size());
+    for (std::string_view document : documents) {
+      results.push_back(ValidateText<MyData>(document));
+    }
+    BenchKeep(results.size());
+  }), bytes);
+
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<unsigned> counts;
+  for (unsigned threads = 1; threads < cores; threads *= 2) {
+    counts.push_back(threads);
+  }
+  counts.push_back(cores);
+
+  for (unsigned threads : counts) {
+    ThreadPool pool(threads);
+    BenchPrint("ValidateBatch(), " + std::to_string(threads) + (threads == 1 ? " thread" : " threads"),
+               BenchRun(5, [&] {
+                 auto results = ValidateBatch<MyData>(documents, ValidationMode::FirstError,
+                                                      JsonParser::ThreadLocal(), pool);
+                 BenchKeep(results.size());
+               }), bytes);
+  }
+}
@@ -0,0 +1,99 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Snapshot of the global allocation counters maintained by the
+ *        benchmark executable's operator new/delete replacements.
+ */
+struct BenchAllocations
+{
+  size_t count;  ///< Number of allocations made so far.
+  size_t bytes;  ///< Number of bytes allocated so far.
+  size_t live;   ///< Number of bytes currently allocated.
+};
+
+/**
+ * @brief Read the global allocation counters.
+ * @return BenchAllocations
+ */
+BenchAllocations BenchReadAllocations();
+
+/**
+ * @brief Per-operation figures for one benchmark case.
+ */
+struct BenchResult
+{
+  double nsPerOp;
+  double allocsPerOp;
+  double bytesPerOp;
+};
+
+/**
+ * @brief Run body a number of times and measure time and allocations.
+ * @param iterations Number of times to run body.
+ * @param body Callable to measure.
+ * @return BenchResult
+ */
+template<typename F>
+BenchResult BenchRun(size_t iterations, F&& body)
+{
+  BenchAllocations before = BenchReadAllocations();
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    body();
+  }
+  auto end = std::chrono::steady_clock::now();
+  BenchAllocations after = BenchReadAllocations();
+
+  double ns = std::chrono::duration<double, std::nano>(end - start).count();
+  return BenchResult{
+    ns / iterations,
+    double(after.count - before.count) / iterations,
+    double(after.bytes - before.bytes) / iterations
+  };
+}
+
+/**
+ * @brief Print one line of benchmark output.
+ * @param name Name of the benchmark case.
+ * @param result Measured figures.
+ * @param inputBytes Bytes of input per operation, for a MB/s column.
+ */
+void BenchPrint(const std::string& name, const BenchResult& result, size_t inputBytes = 0);
+
+/**
+ * @brief Prevent the compiler from optimising away a computed value.
+ */
+template<typename T>
+inline void BenchKeep(const T& value)
+{
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Benchmark groups, one per source file in bench/
+void RunArrayBench();
+void RunBackendBench();
+void RunBatchBench();
+void RunDispatchBench();
+void RunFieldHashBench();
+void RunFileBench();
+void RunFootprintBench();
+void RunIndexBench();
+void RunIntegerBench();
+void RunLinesBench();
+void RunMatrixBench();
+void RunOwnershipBench();
+void RunParallelBench();
+void RunPushBench();
+void RunSinkBench();
+void RunStringBench();
+void RunUtf8Bench();
+void RunNestedBench();
+void RunNumberBench();
+void RunOnDemandBench();
+
+#endif // BENCH_H
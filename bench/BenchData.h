@@ -0,0 +1,137 @@
+#ifndef BENCH_DATA_H
+#define BENCH_DATA_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ValidatedJson.h"
+
+// Documents and types shared by the benchmark groups.
+
+/**
+ * @brief Recursive type for measuring nesting depth.
+ */
+class BenchNode : public ValidatedJson
+{
+public:
+  BenchNode(JsonData&& data) :
+    ValidatedJson(std::move(data))
+  {
+    Required("value", _value);
+    Required("children", _children);
+  }
+
+private:
+  int _value;
+  std::vector<BenchNode> _children;
+};
+
+/**
+ * @brief Make a chain of BenchNode objects nested depth levels deep.
+ */
+inline std::string MakeBenchChain(int depth)
+{
+  std::string json;
+  for (int i = 0; i < depth; i++) {
+    json += "{\"value\": " + std::to_string(i) + ", \"payload\": \"xxxxxxxxxxxxxxxx\", \"children\": [";
+  }
+  for (int i = 0; i < depth; i++) {
+    json += "]}";
+  }
+  return json;
+}
+
+/**
+ * @brief Kinds of invalid MyData document, cycled through by MakeMyData().
+ */
+enum class BenchDefect
+{
+  None,
+  MissingKey,     ///< "description" is absent.
+  WrongType,      ///< "nested.age" is a string.
+  BadElement      ///< The last element of "values" is a string.
+};
+
+/**
+ * @brief Make a MyData document with a values array of the given length.
+ */
+inline std::string MakeMyData(size_t values, BenchDefect defect = BenchDefect::None)
+{
+  std::string json = "{\"name\": \"benchmark document\"";
+  if (defect != BenchDefect::MissingKey) {
+    json += ", \"description\": \"generated for validated_json_bench\"";
+  }
+  json += defect == BenchDefect::WrongType ? ", \"nested\": {\"age\": \"thirty\"}"
+                                           : ", \"nested\": {\"age\": 30}";
+  json += ", \"values\": [";
+  for (size_t i = 0; i < values; i++) {
+    bool bad = defect == BenchDefect::BadElement && i + 1 == values;
+    json += (i ? ", " : "") + (bad ? std::string("\"x\"") : std::to_string(i * 37 % 100000));
+  }
+  return json + "]}";
+}
+
+/**
+ * @brief Make an array of records mixing strings, escapes, nesting and literals.
+ */
+inline std::string MakeRecords(size_t records)
+{
+  std::string json = "[";
+  for (size_t i = 0; i < records; i++) {
+    json += (i ? ", " : "");
+    json += "{\"id\": " + std::to_string(i) + ", \"name\": \"record \\\"" + std::to_string(i) + "\\\"\""
+            ", \"active\": " + (i % 2 ? "true" : "false") + ", \"score\": " + std::to_string(i * 0.25) +
+            ", \"tags\": [\"alpha\", \"beta\", null], \"owner\": {\"login\": \"user" + std::to_string(i % 97) +
+            "\", \"url\": \"https://example.com/u/" + std::to_string(i) + "\"}}";
+  }
+  return json + "]";
+}
+
+/**
+ * @brief One record of the file written by WriteBenchLines().
+ */
+class BenchLineRecord : public ValidatedJson
+{
+public:
+  BenchLineRecord(JsonData&& data) :
+    ValidatedJson(std::move(data), JsonStorage::Release)
+  {
+    Bind(*this);
+  }
+
+  static constexpr auto Fields()
+  {
+    return FieldList(Required("id", &BenchLineRecord::_id),
+                     Required("name", &BenchLineRecord::_name),
+                     Required("active", &BenchLineRecord::_active),
+                     Required("score", &BenchLineRecord::_score),
+                     Required("tags", &BenchLineRecord::_tags));
+  }
+
+private:
+  int _id;
+  std::string _name;
+  bool _active;
+  double _score;
+  std::vector<std::string> _tags;
+};
+
+/**
+ * @brief Write a JSON Lines file of BenchLineRecord, one line in a hundred
+ *        invalid.
+ * @return Path of the file, for the caller to remove.
+ */
+inline std::string WriteBenchLines(size_t records)
+{
+  std::string path = "/tmp/validated_json_bench_lines.ndjson";
+  std::ofstream out(path);
+  for (size_t i = 0; i < records; i++) {
+    out << "{\"id\": " << (i % 100 == 99 ? "\"bad\"" : std::to_string(i)) << ", \"name\": \"record " << i
+        << "\", \"active\": " << (i % 2 ? "true" : "false") << ", \"score\": " << i * 0.25
+        << ", \"tags\": [\"alpha\", \"beta\"], \"owner\": {\"login\": \"user" << i % 97 << "\"}}\n";
+  }
+  return path;
+}
+
+#endif // BENCH_DATA_H
@@ -0,0 +1,127 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+
+// Allocation counting. Each block carries a header recording its size so that
+// live bytes can be tracked without relying on sized deallocation.
+
+namespace
+{
+std::atomic<size_t> allocCount{0};
+std::atomic<size_t> allocBytes{0};
+std::atomic<size_t> allocLive{0};
+
+constexpr size_t kHeader = alignof(std::max_align_t);
+
+void* CountedAlloc(size_t size)
+{
+  void* block = std::malloc(size + kHeader);
+  if (block == nullptr) {
+    return nullptr;
+  }
+  *static_cast<size_t*>(block) = size;
+  allocCount.fetch_add(1, std::memory_order_relaxed);
+  allocBytes.fetch_add(size, std::memory_order_relaxed);
+  allocLive.fetch_add(size, std::memory_order_relaxed);
+  return static_cast<char*>(block) + kHeader;
+}
+
+void CountedFree(void* ptr)
+{
+  if (ptr == nullptr) {
+    return;
+  }
+  void* block = static_cast<char*>(ptr) - kHeader;
+  allocLive.fetch_sub(*static_cast<size_t*>(block), std::memory_order_relaxed);
+  std::free(block);
+}
+}
+
+void* operator new(size_t size)
+{
+  void* ptr = CountedAlloc(size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+void operator delete(void* ptr) noexcept { CountedFree(ptr); }
+void operator delete[](void* ptr) noexcept { CountedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { CountedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { CountedFree(ptr); }
+
+BenchAllocations BenchReadAllocations()
+{
+  return BenchAllocations{
+    allocCount.load(std::memory_order_relaxed),
+    allocBytes.load(std::memory_order_relaxed),
+    allocLive.load(std::memory_order_relaxed)
+  };
+}
+
+void BenchPrint(const std::string& name, const BenchResult& result, size_t inputBytes)
+{
+  std::printf("%-48s %12.1f ns/op %10.1f allocs/op %12.1f bytes/op",
+              name.c_str(), result.nsPerOp, result.allocsPerOp, result.bytesPerOp);
+  if (inputBytes > 0) {
+    std::printf(" %9.1f MB/s", inputBytes / result.nsPerOp * 1e9 / (1024 * 1024));
+  }
+  std::printf("\n");
+}
+
+int main(int argc, char* argv[])
+{
+  struct Group
+  {
+    const char* name;
+    std::function<void()> run;
+  };
+
+  const std::vector<Group> groups{
+    {"ownership", RunOwnershipBench},
+    {"nested", RunNestedBench},
+    {"footprint", RunFootprintBench},
+    {"dispatch", RunDispatchBench},
+    {"fieldhash", RunFieldHashBench},
+    {"file", RunFileBench},
+    {"string", RunStringBench},
+    {"matrix", RunMatrixBench},
+    {"backend", RunBackendBench},
+    {"index", RunIndexBench},
+    {"utf8", RunUtf8Bench},
+    {"number", RunNumberBench},
+    {"ondemand", RunOnDemandBench},
+    {"lines", RunLinesBench},
+    {"push", RunPushBench},
+    {"sink", RunSinkBench},
+    {"parallel", RunParallelBench},
+    {"batch", RunBatchBench},
+    {"array", RunArrayBench},
+    {"integer", RunIntegerBench},
+  };
+
+  // Run every group, or only the groups named on the command line
+  for (const auto& group : groups) {
+    bool selected = argc < 2;
+    for (int i = 1; i < argc; i++) {
+      selected = selected || std::strcmp(argv[i], group.name) == 0;
+    }
+    if (selected) {
+      std::printf("== %s\n", group.name);
+      group.run();
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,34 @@
+#include <string>
+
+#include "Bench.h"
+#include "WideData.h"
+
+// Compares per-key Required() lookups with single-pass Bind() dispatch as
+// objects get wider.
+
+namespace
+{
+template<size_t N>
+void CompareDispatch()
+{
+  JsonString document(MakeWideDocument(N));
+  size_t iterations = 200000 / N;
+
+  BenchPrint("Required() x " + std::to_string(N), BenchRun(iterations, [&] {
+    WideRequired<N> data{JsonData(document.GetSnapshot())};
+    BenchKeep(data);
+  }));
+
+  BenchPrint("Bind() x " + std::to_string(N), BenchRun(iterations, [&] {
+    WideBound<N> data{JsonData(document.GetSnapshot())};
+    BenchKeep(data);
+  }));
+}
+}
+
+void RunDispatchBench()
+{
+  CompareDispatch<4>();
+  CompareDispatch<32>();
+  CompareDispatch<256>();
+}
@@ -0,0 +1,58 @@
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Bench.h"
+#include "WideData.h"
+
+// Microbenchmarks of matching member names to declared fields: the
+// compile-time perfect hash against a string-keyed std::map.
+
+namespace
+{
+template<size_t N>
+void CompareLookup()
+{
+  using Index = FieldIndex<WideBound<N>>;
+
+  // Every declared key, plus as many names that are not declared
+  std::vector<std::string> names;
+  for (size_t i = 0; i < 2 * N; i++) {
+    names.push_back("telemetry_field_" + std::to_string(1000 + i).substr(1));
+  }
+
+  std::map<std::string, int, std::less<>> map;
+  for (size_t i = 0; i < N; i++) {
+    map.emplace(names[i], int(i));
+  }
+
+  size_t iterations = 1000000 / names.size();
+
+  BenchResult hash = BenchRun(iterations, [&] {
+    for (const auto& name : names) {
+      int index = Index::Find(name.data(), name.size());
+      BenchKeep(index);
+    }
+  });
+  hash.nsPerOp /= names.size();
+  BenchPrint("perfect hash lookup, " + std::to_string(N) + " fields", hash);
+
+  BenchResult tree = BenchRun(iterations, [&] {
+    for (const auto& name : names) {
+      auto it = map.find(std::string_view(name));
+      int index = it == map.end() ? -1 : it->second;
+      BenchKeep(index);
+    }
+  });
+  tree.nsPerOp /= names.size();
+  BenchPrint("std::map lookup, " + std::to_string(N) + " fields", tree);
+}
+}
+
+void RunFieldHashBench()
+{
+  CompareLookup<4>();
+  CompareLookup<32>();
+  CompareLookup<256>();
+}
@@ -0,0 +1,49 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "Bench.h"
+#include "ValidatedJson.h"
+
+// Compares loading a large JSON file through a memory mapping with parsing
+// it from a std::ifstream.
+
+namespace
+{
+std::string WriteLargeFile(size_t records)
+{
+  std::string path = "/tmp/validated_json_bench_large.json";
+  std::ofstream out(path);
+  out << "{\"records\": [";
+  for (size_t i = 0; i < records; i++) {
+    out << (i ? ", " : "") << "{\"id\": " << i << ", \"name\": \"record " << i
+        << "\", \"score\": " << i * 0.5 << ", \"tags\": [\"a\", \"b\", \"c\"]}";
+  }
+  out << "]}";
+  return path;
+}
+}
+
+void RunFileBench()
+{
+  std::string path = WriteLargeFile(100000);
+  std::ifstream probe(path, std::ios::ate);
+  size_t size = probe.tellg();
+
+  BenchResult mapped = BenchRun(5, [&] {
+    JsonFile file(path);
+    BenchKeep(file);
+  });
+  BenchPrint("JsonFile (mapped)", mapped, size);
+
+  BenchResult stream = BenchRun(5, [&] {
+    Json::Value root;
+    std::string errors;
+    std::ifstream in(path);
+    Json::parseFromStream(Json::CharReaderBuilder(), in, &root, &errors);
+    BenchKeep(root);
+  });
+  BenchPrint("std::ifstream + parseFromStream", stream, size);
+
+  std::remove(path.c_str());
+}
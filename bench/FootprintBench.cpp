@@ -0,0 +1,88 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "ValidatedJson.h"
+
+// Reports the resident memory of many bound objects with the tree retained
+// and with it released once binding has finished, and of a releasing
+// parent whose nested object retains, which keeps the whole tree.
+
+namespace
+{
+template<JsonStorage Storage>
+class Limits : public ValidatedJson
+{
+public:
+  Limits(JsonData&& data) :
+    ValidatedJson(std::move(data), Storage)
+  {
+    Required("min", _min);
+    Required("max", _max);
+  }
+
+  Limits() {}
+
+private:
+  int _min;
+  int _max;
+};
+
+template<JsonStorage Storage, JsonStorage LimitsStorage = Storage>
+class Config : public ValidatedJson
+{
+public:
+  Config(JsonData&& data) :
+    ValidatedJson(std::move(data), Storage)
+  {
+    Required("name", _name);
+    Required("description", _description);
+    Required("limits", _limits);
+    Required("values", _values);
+  }
+
+private:
+  std::string _name;
+  std::string _description;
+  Limits<LimitsStorage> _limits;
+  std::vector<int> _values;
+};
+
+std::string MakeConfig(int index)
+{
+  std::string json = "{\"name\": \"config-" + std::to_string(index) + "\","
+    " \"description\": \"resident configuration object\","
+    " \"limits\": {\"min\": 0, \"max\": 100},"
+    " \"tags\": [\"alpha\", \"beta\", \"gamma\"],"
+    " \"values\": [";
+  for (int i = 0; i < 16; i++) {
+    json += (i ? ", " : "") + std::to_string(i * index);
+  }
+  return json + "]}";
+}
+
+template<JsonStorage Storage, JsonStorage LimitsStorage = Storage>
+void ReportFootprint(const char* name, size_t count)
+{
+  std::vector<Config<Storage, LimitsStorage>> objects;
+  objects.reserve(count);
+
+  size_t before = BenchReadAllocations().live;
+  for (size_t i = 0; i < count; i++) {
+    objects.emplace_back(JsonString(MakeConfig(int(i))));
+  }
+  size_t after = BenchReadAllocations().live;
+
+  std::printf("%-48s %12.1f bytes/object\n", name, double(after - before) / count);
+}
+}
+
+void RunFootprintBench()
+{
+  constexpr size_t kObjects = 10000;
+  ReportFootprint<JsonStorage::Retain>("resident footprint, JsonStorage::Retain", kObjects);
+  ReportFootprint<JsonStorage::Release>("resident footprint, JsonStorage::Release", kObjects);
+  ReportFootprint<JsonStorage::Release, JsonStorage::Retain>("resident footprint, Release with Retain nested",
+                                                             kObjects);
+}
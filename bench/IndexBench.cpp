@@ -0,0 +1,82 @@
+#include <string>
+#include <string_view>
+
+#include "Bench.h"
+#include "BenchData.h"
+#include "JsonIndex.h"
+#include "MyData.h"
+
+// Structural indexing throughput of each kernel the CPU supports, then the
+// built-in reader with and without the index on compact and indented text.
+
+namespace
+{
+const char* KernelName(JsonIndex::Kernel kernel)
+{
+  switch (kernel) {
+    case JsonIndex::Kernel::Avx2: return "avx2";
+    case JsonIndex::Kernel::Sse42: return "sse4.2";
+    default: return "scalar";
+  }
+}
+
+std::string Indent(const std::string& json)
+{
+  Json::Value root;
+  std::string errors;
+  JsonParser::ThreadLocal().Parse(json.data(), json.data() + json.size(), root, errors);
+  return root.toStyledString();
+}
+}
+
+void RunIndexBench()
+{
+  const std::string records = MakeRecords(16384);
+  const std::string numbers = MakeMyData(262144);
+
+  for (const auto& [name, json] : {std::pair<const char*, const std::string&>{"records", records},
+                                   std::pair<const char*, const std::string&>{"numbers", numbers}}) {
+    for (JsonIndex::Kernel kernel : {JsonIndex::Kernel::Scalar, JsonIndex::Kernel::Sse42,
+                                     JsonIndex::Kernel::Avx2}) {
+      if (!JsonIndex::Supported(kernel)) {
+        continue;
+      }
+      // Index once first, so the buffer is already grown
+      JsonIndex index;
+      index.Build(json.data(), json.size(), kernel);
+      BenchPrint(std::string("index ") + name + ", " + KernelName(kernel), BenchRun(20, [&] {
+        index.Build(json.data(), json.size(), kernel);
+        BenchKeep(index.Size());
+      }), json.size());
+    }
+  }
+
+  const std::string compact = MakeRecords(1024);
+  const std::string indented = Indent(compact);
+  for (const auto& [name, json] : {std::pair<const char*, const std::string&>{"compact", compact},
+                                   std::pair<const char*, const std::string&>{"indented", indented}}) {
+    for (bool indexed : {false, true}) {
+      JsonParserSettings settings;
+      settings.backend = JsonBackend::Builtin;
+      settings.structuralIndex = indexed;
+      JsonParser parser(settings);
+      BenchPrint(std::string("builtin parse records, ") + name + (indexed ? ", indexed" : ", unindexed"),
+                 BenchRun(50, [&] {
+                   JsonString data{std::string_view(json), parser};
+                   BenchKeep(data);
+                 }), json.size());
+    }
+  }
+
+  const std::string document = Indent(MakeMyData(65536));
+  for (bool indexed : {false, true}) {
+    JsonParserSettings settings;
+    settings.structuralIndex = indexed;
+    JsonParser parser(settings);
+    BenchPrint(std::string("bind MyData from JsonText, indented, ") + (indexed ? "indexed" : "unindexed"),
+               BenchRun(20, [&] {
+                 MyData data{JsonText(document, parser)};
+                 BenchKeep(data);
+               }), document.size());
+  }
+}
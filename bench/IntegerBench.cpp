@@ -0,0 +1,89 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "ValidatedJson.h"
+
+// Fixed-width integers: 64-bit ids and counters and 16-bit ports, checked
+// with isInt64() and friends then read with asInt64() on a tree, against
+// binding them with a single range check each from the same tree, and
+// parsing and binding them from text.
+
+namespace
+{
+/**
+ * @brief Connection table with a column per integer width.
+ */
+class Connections : public ValidatedJson
+{
+public:
+  Connections(JsonData&& data) :
+    ValidatedJson(std::move(data), JsonStorage::Release)
+  {
+    Bind(*this);
+  }
+
+  static constexpr auto Fields()
+  {
+    return FieldList(Required("ids", &Connections::_ids),
+                     Required("bytes", &Connections::_bytes),
+                     Required("ports", &Connections::_ports));
+  }
+
+private:
+  std::vector<int64_t> _ids;
+  std::vector<uint64_t> _bytes;
+  std::vector<uint16_t> _ports;
+};
+
+std::string MakeConnections(size_t rows)
+{
+  std::string ids;
+  std::string bytes;
+  std::string ports;
+  for (uint64_t i = 0; i < rows; i++) {
+    const char* comma = i ? "," : "";
+    ids += comma + std::to_string(int64_t(i * 0x9E3779B97F4A7C15ull));
+    bytes += comma + std::to_string(i * 0xC2B2AE3D27D4EB4Full >> (i % 48));
+    ports += comma + std::to_string(1024 + i * 7 % 64512);
+  }
+  return "{\"ids\":[" + ids + "],\"bytes\":[" + bytes + "],\"ports\":[" + ports + "]}";
+}
+}
+
+void RunIntegerBench()
+{
+  const std::string json = MakeConnections(65536);
+  const JsonString tree(json);
+  const Json::Value& root = tree.GetRoot();
+
+  BenchPrint("isInt64() + asInt64() on the tree", BenchRun(20, [&] {
+    uint64_t sum = 0;
+    for (const Json::Value& id : root["ids"]) {
+      sum += id.isInt64() ? static_cast<uint64_t>(id.asInt64()) : 0;
+    }
+    for (const Json::Value& bytes : root["bytes"]) {
+      sum += bytes.isUInt64() ? bytes.asUInt64() : 0;
+    }
+    for (const Json::Value& port : root["ports"]) {
+      sum += port.isUInt() && port.asUInt() <= 65535 ? port.asUInt() : 0;
+    }
+    BenchKeep(sum);
+  }), json.size());
+
+  BenchPrint("bind Connections from the same tree", BenchRun(20, [&] {
+    Connections connections{JsonData(tree.GetSnapshot())};
+    BenchKeep(connections);
+  }), json.size());
+
+  BenchPrint("bind Connections from JsonString", BenchRun(10, [&] {
+    Connections connections{JsonString(json)};
+    BenchKeep(connections);
+  }), json.size());
+
+  BenchPrint("bind Connections from JsonText", BenchRun(20, [&] {
+    Connections connections{JsonText(json)};
+    BenchKeep(connections);
+  }), json.size());
+}
@@ -0,0 +1,38 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "Bench.h"
+#include "BenchData.h"
+#include "JsonLinesFile.h"
+
+// Reads a JSON Lines file with one record per line, one line in a hundred
+// invalid: JsonLinesFile against std::getline and Validate() on each line.
+
+void RunLinesBench()
+{
+  std::string path = WriteBenchLines(200000);
+  std::ifstream probe(path, std::ios::ate);
+  size_t size = probe.tellg();
+
+  BenchPrint("JsonLinesFile", BenchRun(5, [&] {
+    size_t valid = 0;
+    JsonLinesFile<BenchLineRecord> lines(path);
+    while (auto line = lines.Next()) {
+      valid += line->result.Ok();
+    }
+    BenchKeep(valid);
+  }), size);
+
+  BenchPrint("std::getline + Validate()", BenchRun(5, [&] {
+    size_t valid = 0;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+      valid += Validate<BenchLineRecord>(line).Ok();
+    }
+    BenchKeep(valid);
+  }), size);
+
+  std::remove(path.c_str());
+}
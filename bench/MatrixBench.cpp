@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "BenchData.h"
+#include "MyData.h"
+
+// The reference matrix for judging performance changes: parsing with
+// JsonString and JsonFile, binding MyData and nested types, across document
+// sizes, array lengths, nesting depths and error rates.
+
+namespace
+{
+// Enough iterations to process a few megabytes, but at least three
+size_t IterationsFor(size_t bytes)
+{
+  return std::max<size_t>(3, (4 << 20) / bytes);
+}
+
+void ParseAndBind()
+{
+  for (size_t values : {8, 1024, 65536, 1048576}) {
+    std::string document = MakeMyData(values);
+    std::string label = std::to_string(values) + " values";
+    size_t iterations = IterationsFor(document.size());
+
+    BenchPrint("parse JsonString, " + label, BenchRun(iterations, [&] {
+      JsonString json(document);
+      BenchKeep(json);
+    }), document.size());
+
+    std::string path = "/tmp/validated_json_bench_matrix.json";
+    std::ofstream(path) << document;
+    BenchPrint("parse JsonFile, " + label, BenchRun(iterations, [&] {
+      JsonFile json(path);
+      BenchKeep(json);
+    }), document.size());
+    std::remove(path.c_str());
+
+    JsonString parsed(document);
+    BenchPrint("bind MyData, " + label, BenchRun(iterations, [&] {
+      MyData data{JsonData(parsed.GetSnapshot())};
+      BenchKeep(data);
+    }), document.size());
+
+    BenchPrint("parse + bind MyData, " + label, BenchRun(iterations, [&] {
+      MyData data{JsonString(document)};
+      BenchKeep(data);
+    }), document.size());
+  }
+}
+
+void NestedDepth()
+{
+  for (int depth : {1, 8, 64, 256}) {
+    std::string document = MakeBenchChain(depth);
+    BenchPrint("parse + bind nested, depth " + std::to_string(depth),
+               BenchRun(IterationsFor(document.size()), [&] {
+      BenchNode node{JsonString(document)};
+      BenchKeep(node);
+    }), document.size());
+  }
+}
+
+void ErrorRate()
+{
+  constexpr size_t kDocuments = 1000;
+  const BenchDefect defects[] = {
+    BenchDefect::MissingKey, BenchDefect::WrongType, BenchDefect::BadElement
+  };
+
+  for (int percent : {0, 10, 30, 100}) {
+    // Spread the invalid documents evenly through the batch
+    std::vector<std::string> documents;
+    size_t bytes = 0;
+    for (size_t i = 0; i < kDocuments; i++) {
+      bool invalid = (i * percent) / 100 != ((i + 1) * percent) / 100;
+      documents.push_back(MakeMyData(16, invalid ? defects[i % 3] : BenchDefect::None));
+      bytes += documents.back().size();
+    }
+
+    BenchResult thrown = BenchRun(20, [&] {
+      for (const auto& document : documents) {
+        try {
+          MyData data{JsonString(document)};
+          BenchKeep(data);
+        } catch (const std::runtime_error&) {
+        }
+      }
+    });
+    BenchResult validated = BenchRun(20, [&] {
+      for (const auto& document : documents) {
+        ValidationResult<MyData> data = Validate<MyData>(document);
+        BenchKeep(data);
+      }
+    });
+    BenchResult collected = BenchRun(20, [&] {
+      for (const auto& document : documents) {
+        ValidationResult<MyData> data = Validate<MyData>(document, ValidationMode::AllErrors);
+        BenchKeep(data);
+      }
+    });
+
+    const std::string label = std::to_string(percent) + "% invalid (per doc)";
+    BenchPrint("parse + bind MyData, throwing, " + label,
+               BenchResult{thrown.nsPerOp / kDocuments, thrown.allocsPerOp / kDocuments,
+                           thrown.bytesPerOp / kDocuments}, bytes / kDocuments);
+    BenchPrint("parse + bind MyData, Validate(), " + label,
+               BenchResult{validated.nsPerOp / kDocuments, validated.allocsPerOp / kDocuments,
+                           validated.bytesPerOp / kDocuments}, bytes / kDocuments);
+    BenchPrint("parse + bind MyData, Validate(AllErrors), " + label,
+               BenchResult{collected.nsPerOp / kDocuments, collected.allocsPerOp / kDocuments,
+                           collected.bytesPerOp / kDocuments}, bytes / kDocuments);
+  }
+}
+}
+
+void RunMatrixBench()
+{
+  ParseAndBind();
+  NestedDepth();
+  ErrorRate();
+}
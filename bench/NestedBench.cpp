@@ -0,0 +1,24 @@
+#include <string>
+
+#include "Bench.h"
+#include "BenchData.h"
+
+// Measures binding cost against nesting depth. With nested objects viewing
+// their parent's tree the cost per level stays flat as depth grows.
+
+void RunNestedBench()
+{
+  for (int depth : {8, 32, 128}) {
+    JsonString document(MakeBenchChain(depth));
+    size_t iterations = 20000 / depth;
+
+    BenchResult result = BenchRun(iterations, [&] {
+      BenchNode node{JsonData(document.GetSnapshot())};
+      BenchKeep(node);
+    });
+
+    BenchPrint("bind depth " + std::to_string(depth) + " (per level)", BenchResult{
+      result.nsPerOp / depth, result.allocsPerOp / depth, result.bytesPerOp / depth
+    });
+  }
+}
@@ -0,0 +1,111 @@
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Bench.h"
+#include "BenchData.h"
+#include "JsonReader.h"
+
+// Number parsing on a telemetry document made almost entirely of numeric
+// arrays: the reader's own conversion against std::from_chars on the same
+// tokens, then binding the document through each path.
+
+namespace
+{
+/**
+ * @brief Telemetry document: integer timestamps and readings with fractions.
+ */
+class Telemetry : public ValidatedJson
+{
+public:
+  Telemetry(JsonData&& data) :
+    ValidatedJson(std::move(data), JsonStorage::Release)
+  {
+    Bind(*this);
+  }
+
+  static constexpr auto Fields()
+  {
+    return FieldList(Required("timestamps", &Telemetry::_timestamps),
+                     Required("readings", &Telemetry::_readings));
+  }
+
+private:
+  std::vector<int> _timestamps;
+  std::vector<double> _readings;
+};
+
+std::string MakeTelemetry(size_t samples)
+{
+  std::string timestamps;
+  std::string readings;
+  for (size_t i = 0; i < samples; i++) {
+    timestamps += (i ? "," : "") + std::to_string(1700000000 + i * 15 % 2000000000);
+    char reading[32];
+    std::snprintf(reading, sizeof(reading), "%s%.4f", i ? "," : "", (i * 7919 % 100000) / 97.0 - 300);
+    readings += reading;
+  }
+  return "{\"timestamps\":[" + timestamps + "],\"readings\":[" + readings + "]}";
+}
+}
+
+void RunNumberBench()
+{
+  const std::string json = MakeTelemetry(65536);
+
+  // The number tokens alone, for the from_chars baseline
+  std::vector<std::pair<const char*, const char*>> tokens;
+  for (const char* c = json.data(); c != json.data() + json.size();) {
+    if (*c == '-' || (*c >= '0' && *c <= '9')) {
+      const char* start = c;
+      while (*c == '-' || *c == '.' || (*c >= '0' && *c <= '9')) {
+        c++;
+      }
+      tokens.emplace_back(start, c);
+    } else {
+      c++;
+    }
+  }
+
+  BenchPrint("numbers, std::from_chars", BenchRun(20, [&] {
+    double sum = 0;
+    for (const auto& [begin, end] : tokens) {
+      double value;
+      std::from_chars(begin, end, value);
+      sum += value;
+    }
+    BenchKeep(sum);
+  }), json.size());
+
+  BenchPrint("numbers, JsonReader::ReadNumber", BenchRun(20, [&] {
+    double sum = 0;
+    JsonReader reader(json.data(), json.data() + json.size());
+    reader.BeginObject();
+    std::string_view name;
+    while (reader.NextMember(name)) {
+      reader.BeginArray();
+      while (reader.NextElement()) {
+        sum += reader.ReadNumber().real;
+      }
+    }
+    BenchKeep(sum);
+  }), json.size());
+
+  for (JsonBackend backend : {JsonBackend::Jsoncpp, JsonBackend::Builtin}) {
+    JsonParserSettings settings;
+    settings.backend = backend;
+    JsonParser parser(settings);
+    BenchPrint(std::string("bind Telemetry from JsonString, ") +
+               (backend == JsonBackend::Builtin ? "builtin" : "jsoncpp"), BenchRun(10, [&] {
+                 Telemetry telemetry{JsonString(json, parser)};
+                 BenchKeep(telemetry);
+               }), json.size());
+  }
+
+  BenchPrint("bind Telemetry from JsonText", BenchRun(20, [&] {
+    Telemetry telemetry{JsonText(json)};
+    BenchKeep(telemetry);
+  }), json.size());
+}
@@ -0,0 +1,155 @@
+#include <string>
+#include <string_view>
+
+#include "Bench.h"
+#include "BenchData.h"
+
+// Binding four keys of a package manifest whose other members are large:
+// from a tree, from text member by member, and from text with the onDemand
+// setting, which skips the other members by matching brackets. Then one key
+// of an object with tens of thousands of members, which must be found among
+// them.
+
+namespace
+{
+/**
+ * @brief Manifest bound with Required()/Optional().
+ */
+class Package : public ValidatedJson
+{
+public:
+  Package(JsonData&& data) :
+    ValidatedJson(std::move(data), JsonStorage::Release)
+  {
+    Required("name", _name);
+    Required("version", _version);
+    Required("description", _description);
+    Optional("license", _license, "UNLICENSED");
+  }
+
+private:
+  std::string _name;
+  std::string _version;
+  std::string _description;
+  std::string _license;
+};
+
+/**
+ * @brief The same manifest bound with Bind().
+ */
+class BoundPackage : public ValidatedJson
+{
+public:
+  BoundPackage(JsonData&& data) :
+    ValidatedJson(std::move(data), JsonStorage::Release)
+  {
+    Bind(*this);
+  }
+
+  static constexpr auto Fields()
+  {
+    return FieldList(Required("name", &BoundPackage::_name),
+                     Required("version", &BoundPackage::_version),
+                     Required("description", &BoundPackage::_description),
+                     Optional("license", &BoundPackage::_license, "UNLICENSED"));
+  }
+
+private:
+  std::string _name;
+  std::string _version;
+  std::string _description;
+  std::string _license;
+};
+
+/**
+ * @brief Object bound from one member of a wide object.
+ */
+class FirstKey : public ValidatedJson
+{
+public:
+  FirstKey(JsonData&& data) :
+    ValidatedJson(std::move(data), JsonStorage::Release)
+  {
+    Required("k0", _value);
+  }
+
+private:
+  int _value;
+};
+
+/**
+ * @brief Make an object with the given number of int members, "k0" first.
+ */
+std::string MakeWideObject(size_t members)
+{
+  std::string json = "{";
+  for (size_t i = 0; i < members; i++) {
+    json += (i ? ", \"k" : "\"k") + std::to_string(i) + "\": " + std::to_string(i);
+  }
+  return json + "}";
+}
+
+/**
+ * @brief Make a manifest like test.json with many dependencies and scripts.
+ */
+std::string MakePackage(size_t entries)
+{
+  std::string dependencies;
+  std::string scripts;
+  std::string keywords;
+  for (size_t i = 0; i < entries; i++) {
+    std::string n = std::to_string(i);
+    dependencies += (i ? ",\n    \"" : "\n    \"") + ("package-" + n) + "\": \"^" + n + ".17.1\"";
+    scripts += (i ? ",\n    \"" : "\n    \"") + ("task-" + n) + "\": \"node scripts/run.js --step " + n +
+               " --flags \\\"{a, b}\\\"\"";
+    keywords += (i ? ", \"" : "\"") + ("keyword-" + n) + "\"";
+  }
+  return "{\n  \"name\": \"Test Project\",\n  \"version\": \"1.0.0\",\n"
+         "  \"description\": \"A sample project to demonstrate JSON structure\",\n"
+         "  \"author\": \"John Doe\",\n  \"license\": \"MIT\",\n"
+         "  \"dependencies\": {" + dependencies + "\n  },\n"
+         "  \"scripts\": {" + scripts + "\n  },\n"
+         "  \"keywords\": [" + keywords + "],\n"
+         "  \"repository\": {\"type\": \"git\", \"url\": \"https://example.com/test.git\"}\n}\n";
+}
+
+template<typename T>
+void BenchText(const std::string& name, const std::string& json, bool onDemand, bool indexed)
+{
+  JsonParserSettings settings;
+  settings.onDemand = onDemand;
+  settings.structuralIndex = indexed;
+  JsonParser parser(settings);
+  BenchPrint(name + (onDemand ? ", on demand" : ", checked") + (indexed ? ", indexed" : ""),
+             BenchRun(50, [&] {
+               T package{JsonText(json, parser)};
+               BenchKeep(package);
+             }), json.size());
+}
+}
+
+void RunOnDemandBench()
+{
+  const std::string json = MakePackage(2000);
+
+  BenchPrint("Package from JsonString", BenchRun(50, [&] {
+    Package package{JsonString(json)};
+    BenchKeep(package);
+  }), json.size());
+
+  for (bool onDemand : {false, true}) {
+    BenchText<Package>("Package from JsonText", json, onDemand, false);
+    BenchText<BoundPackage>("BoundPackage from JsonText", json, onDemand, false);
+  }
+  BenchText<BoundPackage>("BoundPackage from JsonText", json, true, true);
+
+  for (size_t members : {10000, 40000}) {
+    const std::string wide = MakeWideObject(members);
+    const std::string name = "FirstKey, " + std::to_string(members) + " members";
+    BenchPrint(name + " from JsonString", BenchRun(10, [&] {
+      FirstKey object{JsonString(wide)};
+      BenchKeep(object);
+    }), wide.size());
+    BenchText<FirstKey>(name + " from JsonText", wide, true, false);
+  }
+}
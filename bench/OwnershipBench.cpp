@@ -0,0 +1,56 @@
+#include <cstdio>
+#include <string>
+
+#include "Bench.h"
+#include "MyData.h"
+
+// Measures how many times a document's tree is copied on its way from the
+// parser into a ValidatedJson object, from the allocations each step makes.
+
+namespace
+{
+const std::string kDocument =
+  "{\"name\": \"bench\", \"description\": \"ownership benchmark\","
+  " \"nested\": {\"age\": 30}, \"values\": [1, 2, 3, 4, 5, 6, 7, 8]}";
+
+constexpr size_t kIterations = 100000;
+}
+
+void RunOwnershipBench()
+{
+  JsonString document(kDocument);
+
+  BenchResult copy = BenchRun(kIterations, [&] {
+    Json::Value copy(document.GetRoot());
+    BenchKeep(copy);
+  });
+  BenchPrint("deep copy of Json::Value (reference)", copy);
+
+  BenchPrint("JsonData from snapshot", BenchRun(kIterations, [&] {
+    JsonData data(document.GetSnapshot());
+    BenchKeep(data);
+  }));
+
+  BenchResult bind = BenchRun(kIterations, [&] {
+    MyData data{JsonData(document.GetSnapshot())};
+    BenchKeep(data);
+  });
+  BenchPrint("MyData from shared JsonData", bind);
+
+  BenchResult parse = BenchRun(kIterations / 10, [&] {
+    JsonString data(kDocument);
+    BenchKeep(data);
+  });
+  BenchPrint("JsonString (parse only)", parse);
+
+  BenchResult whole = BenchRun(kIterations / 10, [&] {
+    MyData data{JsonString(kDocument)};
+    BenchKeep(data);
+  });
+  BenchPrint("MyData from JsonString (parse + bind)", whole);
+
+  // Allocations of parse + bind beyond those of parsing and of binding a
+  // shared tree, in units of one deep copy of the tree
+  double extra = whole.allocsPerOp - parse.allocsPerOp - bind.allocsPerOp;
+  std::printf("root copies/doc: %.2f\n", extra / copy.allocsPerOp);
+}
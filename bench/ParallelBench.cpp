@@ -0,0 +1,54 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Bench.h"
+#include "BenchData.h"
+#include "ParallelJsonLines.h"
+
+// Binds a JSON Lines file on 1 to N threads, N being the hardware threads,
+// in file order and as chunks finish, against JsonLinesFile on one thread.
+
+void RunParallelBench()
+{
+  std::string path = WriteBenchLines(200000);
+  std::ifstream probe(path, std::ios::ate);
+  size_t size = probe.tellg();
+
+  BenchPrint("JsonLinesFile, 1 thread", BenchRun(5, [&] {
+    size_t valid = 0;
+    JsonLinesFile<BenchLineRecord> lines(path);
+    while (auto line = lines.Next()) {
+      valid += line->result.Ok();
+    }
+    BenchKeep(valid);
+  }), size);
+
+  // Powers of two up to the number of hardware threads, and that number
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<unsigned> counts;
+  for (unsigned threads = 1; threads < cores; threads *= 2) {
+    counts.push_back(threads);
+  }
+  counts.push_back(cores);
+
+  for (unsigned threads : counts) {
+    ThreadPool pool(threads);
+    for (LineOrder order : {LineOrder::Ordered, LineOrder::Unordered}) {
+      std::string name = std::string("ParallelJsonLines, ") +
+                         (order == LineOrder::Ordered ? "ordered, " : "unordered, ") +
+                         std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+      BenchPrint(name, BenchRun(5, [&] {
+        size_t valid = 0;
+        ParallelJsonLines<BenchLineRecord> lines(path, pool, order);
+        lines.ForEach([&](JsonLine<BenchLineRecord>&& line) { valid += line.result.Ok(); });
+        BenchKeep(valid);
+      }), size);
+    }
+  }
+
+  std::remove(path.c_str());
+}
@@ -0,0 +1,75 @@
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "Bench.h"
+#include "BenchData.h"
+#include "JsonPushParser.h"
+#include "MyData.h"
+
+// A document arriving in chunks: fed to JsonPushParser a chunk at a time,
+// against collecting every chunk before parsing, and against JsonData read
+// from a stream, which blocks until the stream ends.
+
+namespace
+{
+/**
+ * @brief Feed a document to a binder in chunks of the given size.
+ */
+template<typename T>
+bool FeedInChunks(JsonPushBinder<T>& binder, const std::string& json, size_t chunkSize)
+{
+  bool ok = false;
+  for (size_t at = 0; at < json.size(); at += chunkSize) {
+    std::string_view chunk(json.data() + at, std::min(chunkSize, json.size() - at));
+    while (!chunk.empty()) {
+      if (auto result = binder.Feed(chunk)) {
+        ok = result->Ok();
+      }
+    }
+  }
+  return ok;
+}
+}
+
+void RunPushBench()
+{
+  const std::string records = MakeRecords(4096);
+  for (size_t chunkSize : {64, 4096, 65536}) {
+    JsonPushParser parser;
+    BenchPrint("parse records, JsonPushParser, " + std::to_string(chunkSize) + " byte chunks",
+               BenchRun(20, [&] {
+                 for (size_t at = 0; at < records.size(); at += chunkSize) {
+                   parser.Feed(records.data() + at, std::min(chunkSize, records.size() - at));
+                 }
+                 parser.Finish();
+                 BenchKeep(parser.Take());
+               }), records.size());
+  }
+
+  BenchPrint("parse records, chunks collected then JsonString", BenchRun(20, [&] {
+    std::string collected;
+    for (size_t at = 0; at < records.size(); at += 4096) {
+      collected.append(records.data() + at, std::min<size_t>(4096, records.size() - at));
+    }
+    JsonString data{std::string_view(collected)};
+    BenchKeep(data);
+  }), records.size());
+
+  BenchPrint("parse records, JsonData from a stream", BenchRun(20, [&] {
+    JsonData data{std::istringstream(records)};
+    BenchKeep(data);
+  }), records.size());
+
+  const std::string document = MakeMyData(65536);
+  for (size_t chunkSize : {64, 4096}) {
+    JsonPushBinder<MyData> binder;
+    BenchPrint("parse + bind MyData, 65536 values, JsonPushBinder, " + std::to_string(chunkSize) +
+               " byte chunks", BenchRun(20, [&] {
+                 BenchKeep(FeedInChunks(binder, document, chunkSize));
+               }), document.size());
+  }
+  BenchPrint("parse + bind MyData, 65536 values, Validate()", BenchRun(20, [&] {
+    BenchKeep(Validate<MyData>(document).Ok());
+  }), document.size());
+}
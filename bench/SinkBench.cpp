@@ -0,0 +1,74 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Bench.h"
+#include "BenchData.h"
+
+// A long array of numbers bound into a std::vector, and streamed through a
+// JsonArraySink which only sums it, from a tree and straight from text. The
+// bytes allocated per document show what each keeps in memory.
+
+namespace
+{
+/**
+ * @brief Document whose values are kept.
+ */
+class Samples : public ValidatedJson
+{
+public:
+  Samples(JsonData&& data) :
+    ValidatedJson(std::move(data), JsonStorage::Release)
+  {
+    Required("values", _values);
+  }
+
+  std::vector<int> _values;
+};
+
+/**
+ * @brief Document whose values are summed as they are bound.
+ */
+class SampleSum : public ValidatedJson
+{
+public:
+  SampleSum(JsonData&& data) :
+    ValidatedJson(std::move(data), JsonStorage::Release),
+    _values([this](int&& value) { _sum += value; })
+  {
+    Required("values", _values);
+  }
+
+  JsonArraySink<int> _values;
+  long long _sum = 0;
+};
+}
+
+void RunSinkBench()
+{
+  for (size_t values : {1024, 1048576}) {
+    const std::string json = MakeMyData(values);
+    const size_t iterations = values < 65536 ? 2000 : 5;
+    const std::string size = std::to_string(values) + " values";
+
+    BenchPrint("std::vector, JsonString (tree), " + size, BenchRun(iterations, [&] {
+      Samples samples{JsonString(std::string_view(json))};
+      BenchKeep(samples._values.size());
+    }), json.size());
+
+    BenchPrint("JsonArraySink, JsonString (tree), " + size, BenchRun(iterations, [&] {
+      SampleSum sum{JsonString(std::string_view(json))};
+      BenchKeep(sum._sum);
+    }), json.size());
+
+    BenchPrint("std::vector, JsonText, " + size, BenchRun(iterations, [&] {
+      Samples samples{JsonText(std::string_view(json))};
+      BenchKeep(samples._values.size());
+    }), json.size());
+
+    BenchPrint("JsonArraySink, JsonText, " + size, BenchRun(iterations, [&] {
+      SampleSum sum{JsonText(std::string_view(json))};
+      BenchKeep(sum._sum);
+    }), json.size());
+  }
+}
@@ -0,0 +1,49 @@
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "Bench.h"
+#include "ValidatedJson.h"
+
+// Small-payload latency of JsonString parsing in place with the reused
+// thread-local parser, against creating a parser per document and against
+// copying the text into a std::stringstream and parsing from the stream.
+
+namespace
+{
+std::string MakePayload(size_t members)
+{
+  std::string json = "{";
+  for (size_t i = 0; i < members; i++) {
+    json += (i ? ", \"k" : "\"k") + std::to_string(i) + "\": " + std::to_string(i * 7);
+  }
+  return json + "}";
+}
+}
+
+void RunStringBench()
+{
+  for (size_t members : {2, 16, 64}) {
+    std::string payload = MakePayload(members);
+    std::string size = std::to_string(payload.size()) + " B";
+
+    BenchPrint("JsonString(string_view), " + size, BenchRun(20000, [&] {
+      JsonString json{std::string_view(payload)};
+      BenchKeep(json);
+    }), payload.size());
+
+    BenchPrint("JsonString, new JsonParser per doc, " + size, BenchRun(20000, [&] {
+      JsonParser parser;
+      JsonString json{std::string_view(payload), parser};
+      BenchKeep(json);
+    }), payload.size());
+
+    BenchPrint("stringstream + parseFromStream, " + size, BenchRun(20000, [&] {
+      Json::Value root;
+      std::string errors;
+      std::stringstream stream(payload);
+      Json::parseFromStream(Json::CharReaderBuilder(), stream, &root, &errors);
+      BenchKeep(root);
+    }), payload.size());
+  }
+}
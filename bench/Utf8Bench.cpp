@@ -0,0 +1,104 @@
+#include <string>
+#include <string_view>
+
+#include "Bench.h"
+#include "BenchData.h"
+#include "JsonReader.h"
+#include "Utf8Validator.h"
+
+// UTF-8 validation throughput of each kernel the CPU supports, then the cost
+// of each Utf8Validation setting when parsing, on mostly ASCII records and on
+// records whose strings are in several scripts.
+
+namespace
+{
+const char* KernelName(Utf8Validator::Kernel kernel)
+{
+  switch (kernel) {
+    case Utf8Validator::Kernel::Avx2: return "avx2";
+    case Utf8Validator::Kernel::Sse42: return "sse4.2";
+    default: return "scalar";
+  }
+}
+
+const char* ValidationName(Utf8Validation validation)
+{
+  switch (validation) {
+    case Utf8Validation::PerString: return "per string";
+    case Utf8Validation::Buffer: return "buffer";
+    default: return "none";
+  }
+}
+
+/**
+ * @brief Make an array of records with Latin, Cyrillic, Greek, CJK and emoji strings.
+ */
+std::string MakeMultilingual(size_t records)
+{
+  const char* names[] = {"Zoë Müller-Lüdenscheidt", "Дмитрий Иванович Менделеев", "Αριστοτέλης Ονάσης",
+                         "山田 太郎 (やまだ たろう)", "김민준 🎉🚀"};
+  const char* cities[] = {"São Paulo", "Москва", "Θεσσαλονίκη", "東京都", "서울특별시"};
+  std::string json = "[";
+  for (size_t i = 0; i < records; i++) {
+    json += (i ? ", " : "");
+    json += "{\"id\": " + std::to_string(i) + ", \"name\": \"" + names[i % 5] + "\", \"city\": \"" +
+            cities[(i / 5) % 5] + "\", \"note\": \"записано в 東京 — ok ✓\", \"active\": " +
+            (i % 2 ? "true" : "false") + "}";
+  }
+  return json + "]";
+}
+}
+
+void RunUtf8Bench()
+{
+  const std::string ascii = MakeRecords(16384);
+  const std::string multilingual = MakeMultilingual(16384);
+
+  for (const auto& [name, json] : {std::pair<const char*, const std::string&>{"ascii", ascii},
+                                   std::pair<const char*, const std::string&>{"multilingual", multilingual}}) {
+    for (Utf8Validator::Kernel kernel : {Utf8Validator::Kernel::Scalar, Utf8Validator::Kernel::Sse42,
+                                         Utf8Validator::Kernel::Avx2}) {
+      if (!Utf8Validator::Supported(kernel)) {
+        continue;
+      }
+      BenchPrint(std::string("validate ") + name + ", " + KernelName(kernel), BenchRun(20, [&] {
+        BenchKeep(Utf8Validator::Valid(json.data(), json.size(), kernel));
+      }), json.size());
+    }
+  }
+
+  // Reading without building a tree, where string scanning is most of the work
+  for (const auto& [name, json] : {std::pair<const char*, const std::string&>{"ascii", ascii},
+                                   std::pair<const char*, const std::string&>{"multilingual", multilingual}}) {
+    for (Utf8Validation validation : {Utf8Validation::None, Utf8Validation::PerString,
+                                      Utf8Validation::Buffer}) {
+      JsonParserSettings settings;
+      settings.utf8 = validation;
+      BenchPrint(std::string("read ") + name + ", utf8 " + ValidationName(validation), BenchRun(20, [&] {
+        if (validation == Utf8Validation::Buffer) {
+          BenchKeep(Utf8Validator::Valid(json.data(), json.size()));
+        }
+        JsonReader reader(json.data(), json.data() + json.size(), settings);
+        reader.Skip();
+        reader.Finish();
+      }), json.size());
+    }
+  }
+
+  // Parsing into a tree with the built-in backend
+  for (const auto& [name, json] : {std::pair<const char*, const std::string&>{"ascii", ascii},
+                                   std::pair<const char*, const std::string&>{"multilingual", multilingual}}) {
+    for (Utf8Validation validation : {Utf8Validation::None, Utf8Validation::PerString,
+                                      Utf8Validation::Buffer}) {
+      JsonParserSettings settings;
+      settings.backend = JsonBackend::Builtin;
+      settings.utf8 = validation;
+      JsonParser parser(settings);
+      BenchPrint(std::string("builtin parse ") + name + ", utf8 " + ValidationName(validation),
+                 BenchRun(5, [&] {
+                   JsonString data{std::string_view(json), parser};
+                   BenchKeep(data);
+                 }), json.size());
+    }
+  }
+}
@@ -0,0 +1,86 @@
+#ifndef WIDE_DATA_H
+#define WIDE_DATA_H
+
+#include <array>
+#include <string>
+#include <utility>
+
+#include "ValidatedJson.h"
+
+// Generated ValidatedJson types with any number of int fields, for measuring
+// how binding scales with the width of an object.
+
+/**
+ * @brief Key of the Ith wide field, e.g. "telemetry_field_007".
+ */
+template<size_t I>
+struct WideKey
+{
+  static constexpr std::array<char, 20> Make()
+  {
+    std::array<char, 20> text{"telemetry_field_000"};
+    text[16] = char('0' + I / 100 % 10);
+    text[17] = char('0' + I / 10 % 10);
+    text[18] = char('0' + I % 10);
+    return text;
+  }
+
+  static constexpr std::array<char, 20> kText = Make();
+};
+
+template<size_t I>
+struct WideSlot
+{
+  int value;
+};
+
+template<typename Sequence, bool UseBind>
+class Wide;
+
+/**
+ * @brief Object with one int field per index, bound either by per-key
+ *        Required() calls or by Bind().
+ */
+template<size_t... I, bool UseBind>
+class Wide<std::index_sequence<I...>, UseBind> : public ValidatedJson, public WideSlot<I>...
+{
+public:
+  Wide(JsonData&& data) :
+    ValidatedJson(std::move(data))
+  {
+    if constexpr (UseBind) {
+      Bind(*this);
+    } else {
+      (ValidatedJson::Required(WideKey<I>::kText.data(), WideSlot<I>::value), ...);
+    }
+  }
+
+  static constexpr auto Fields()
+  {
+    return FieldList(ValidatedJson::Required(WideKey<I>::kText.data(),
+                                             static_cast<int Wide::*>(&WideSlot<I>::value))...);
+  }
+
+  int Sum() const { return (WideSlot<I>::value + ...); }
+};
+
+template<size_t N>
+using WideRequired = Wide<std::make_index_sequence<N>, false>;
+
+template<size_t N>
+using WideBound = Wide<std::make_index_sequence<N>, true>;
+
+/**
+ * @brief Make a JSON object with values for the first n wide fields.
+ */
+inline std::string MakeWideDocument(size_t n)
+{
+  std::string json = "{";
+  for (size_t i = 0; i < n; i++) {
+    std::string key = "telemetry_field_" + std::to_string(1000 + i).substr(1);
+    json += (i ? ", \"" : "\"") + key + "\": " + std::to_string(i);
+  }
+  return json + "}";
+}
+
+#endif // WIDE_DATA_H
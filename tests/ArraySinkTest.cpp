@@ -0,0 +1,161 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "MyData.h"
+#include "Test.h"
+
+// Elements streamed through a JsonArraySink against the same array bound into
+// a std::vector, from a tree and from text.
+
+namespace
+{
+template<typename T>
+class Listed : public ValidatedJson
+{
+public:
+  Listed(JsonData&& data) :
+    ValidatedJson(std::move(data))
+  {
+    Required("values", _values);
+  }
+
+  std::vector<T> _values;
+};
+
+template<typename T>
+class Streamed : public ValidatedJson
+{
+public:
+  Streamed(JsonData&& data, std::vector<T>& received) :
+    ValidatedJson(std::move(data)),
+    _values([&received](T&& value) { received.push_back(std::move(value)); })
+  {
+    Required("values", _values);
+  }
+
+  JsonArraySink<T> _values;
+};
+
+template<typename T>
+class BoundStreamed : public ValidatedJson
+{
+public:
+  BoundStreamed(JsonData&& data, std::vector<T>& received) :
+    ValidatedJson(std::move(data)),
+    _values([&received](T&& value) { received.push_back(std::move(value)); })
+  {
+    Bind(*this);
+  }
+
+  static constexpr auto Fields()
+  {
+    return FieldList(Required("values", &BoundStreamed::_values));
+  }
+
+  JsonArraySink<T> _values;
+};
+
+template<typename T>
+std::vector<std::string> Describe(const std::vector<T>& values)
+{
+  std::vector<std::string> described;
+  for (const T& value : values) {
+    if constexpr (std::is_base_of_v<ValidatedJson, T>) {
+      described.push_back(value.ToString());
+    } else if constexpr (std::is_same_v<T, std::string>) {
+      described.push_back(value);
+    } else {
+      described.push_back(std::to_string(value));
+    }
+  }
+  return described;
+}
+
+bool SameErrors(const ValidationErrors& expected, const ValidationErrors& actual)
+{
+  if (expected.size() != actual.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < expected.size(); i++) {
+    if (expected[i].message != actual[i].message || expected[i].path != actual[i].path) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Bind a document into a std::vector and through both kinds of sink,
+ *        and check that they fail alike and that each sink received what the
+ *        vector holds. Where binding fails, the sinks are checked against
+ *        the elements they should have received.
+ */
+template<typename T, typename Make>
+bool SinkMatches(const std::string& json, ValidationMode mode, Make make,
+                 const std::vector<std::string>& receivedOnError)
+{
+  ValidationResult<Listed<T>> listed = Validate<Listed<T>>(make(json), mode);
+  std::vector<T> streamed;
+  std::vector<T> bound;
+  ValidationResult<Streamed<T>> sink = Validate<Streamed<T>>(make(json), mode, streamed);
+  ValidationResult<BoundStreamed<T>> boundSink = Validate<BoundStreamed<T>>(make(json), mode, bound);
+
+  bool same = SameErrors(listed.Errors(), sink.Errors()) && SameErrors(listed.Errors(), boundSink.Errors());
+  const std::vector<std::string> expected = listed.Ok() ? Describe(listed.Value()._values) : receivedOnError;
+  same = same && Describe(streamed) == expected && Describe(bound) == expected;
+  if (sink.Ok() && boundSink.Ok()) {
+    same = same && sink.Value()._values.Count() == expected.size() &&
+           boundSink.Value()._values.Count() == expected.size();
+  }
+  if (!same) {
+    std::printf("differs: %s\n", json.c_str());
+  }
+  return same;
+}
+
+template<typename T>
+bool SinkMatches(const std::string& json, const std::vector<std::string>& firstError = {},
+                 const std::vector<std::string>& allErrors = {})
+{
+  auto fromTree = [](const std::string& text) { return JsonString(text); };
+  auto fromText = [](const std::string& text) { return JsonText(text); };
+  return SinkMatches<T>(json, ValidationMode::FirstError, fromTree, firstError) &&
+         SinkMatches<T>(json, ValidationMode::AllErrors, fromTree, allErrors) &&
+         SinkMatches<T>(json, ValidationMode::FirstError, fromText, firstError) &&
+         SinkMatches<T>(json, ValidationMode::AllErrors, fromText, allErrors);
+}
+}
+
+TEST_CASE("numbers reach the sink as they fill a vector")
+{
+  CHECK(SinkMatches<int>("{\"values\": [1, -2, 3, 2147483647, -2147483648]}"));
+  CHECK(SinkMatches<int>("{\"values\": []}"));
+  CHECK(SinkMatches<double>("{\"values\": [0.5, -1e10, 3]}"));
+  CHECK(SinkMatches<int>("{\"values\": [1, \"x\", 3, 4.5, 5, 2147483648, null]}", {"1"}, {"1", "3", "5"}));
+  CHECK(SinkMatches<int>("{\"values\": 5}"));
+  CHECK(SinkMatches<int>("{\"values\": {\"0\": 1}}"));
+  CHECK(SinkMatches<int>("{}"));
+}
+
+TEST_CASE("strings reach the sink as they fill a vector")
+{
+  CHECK(SinkMatches<std::string>("{\"values\": [\"a\", \"\", \"caf\\u00e9\"]}"));
+  CHECK(SinkMatches<std::string>("{\"values\": [\"a\", 1, \"b\", null, \"c\"]}", {"a"}, {"a", "b", "c"}));
+}
+
+TEST_CASE("objects reach the sink as they fill a vector")
+{
+  CHECK(SinkMatches<MyData2>("{\"values\": [{\"age\": 1}, {\"age\": 2}]}"));
+  const std::string age1 = "MyData2: age = 1\n";
+  const std::string age4 = "MyData2: age = 4\n";
+  CHECK(SinkMatches<MyData2>("{\"values\": [{\"age\": 1}, {\"age\": \"x\"}, 3, {}, {\"age\": 4}]}",
+                             {age1}, {age1, age4}));
+}
+
+TEST_CASE("only the last of duplicate arrays reaches the sink")
+{
+  CHECK(SinkMatches<int>("{\"values\": [1, 2], \"values\": [3]}"));
+  CHECK(SinkMatches<int>("{\"values\": [\"x\", 2], \"values\": [3, 4]}"));
+  CHECK(SinkMatches<int>("{\"values\": [1, 2], \"values\": [\"x\", 4]}", {}, {"4"}));
+}
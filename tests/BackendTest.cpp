@@ -0,0 +1,192 @@
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "JsonParser.h"
+#include "Test.h"
+
+// The builtin backend against jsoncpp on the same documents. The builtin
+// reader is strict RFC 8259 whatever the settings, so documents which only
+// jsoncpp's lenient grammar accepts are checked separately.
+
+namespace
+{
+const std::vector<std::string> kValid = {
+  "{}",
+  "[]",
+  "null",
+  "  \n\t{ \"a\" : [ 1 , 2 , { \"b\" : null } ] }  ",
+  "{\"nested\": {\"deeper\": {\"deepest\": [[], {}, [[[]]]]}}}",
+  "[true, false, null, \"\", \"text\"]",
+  "[\"\\\"\\\\\\/\\b\\f\\n\\r\\t\", \"\\u0041\\u00e9\\u20ac\", \"\\ud83d\\ude00\"]",
+  "[\"caf\xc3\xa9\", \"\xe2\x82\xac\", \"\xf0\x9f\x98\x80\"]",
+  "[0, -0, 1, -1, 2147483647, -2147483648, 4294967295, 4294967296]",
+  "[9223372036854775807, -9223372036854775808, 18446744073709551615]",
+  "[18446744073709551616, -9223372036854775809, 123456789012345678901234567890]",
+  "[0.5, -0.25, 1e10, 1E-10, 1.5e+3, 3.141592653589793, 2.2250738585072014e-308]",
+  "[1.7976931348623157e308, 4.9e-324, 5e-324, 0.1e1, 100e-2]",
+  "[1e-400, -1e-400, 0.0000000001e-400, 123456e-500]",
+  "{\"duplicate\": 1, \"duplicate\": 2}",
+};
+
+const std::vector<std::string> kInvalid = {
+  "",
+  "[",
+  "{\"a\" 1}",
+  "{\"a\": }",
+  "[.5]",
+  "[1e]",
+  "[tru]",
+  "[\"unterminated]",
+  "[\"\\x\"]",
+  "[\"\\u12\"]",
+  "[1e400]",
+  "[-1e400]",
+};
+
+// Accepted by jsoncpp, but not JSON
+const std::vector<std::string> kLenient = {
+  "[1, 2, 3,]",
+  "// comment\n[1, /* inline */ 2]",
+  "[01]",
+  "[1.]",
+  "[-]",
+};
+
+// Accepted by jsoncpp unless strict is set
+const std::vector<std::string> kStrictRejects = {
+  "{} trailing",
+  "[1] [2]",
+  "[1, 2,]",
+  "{\"a\": 1,}",
+  "// comment\n[1]",
+  "[1, /* inline */ 2]",
+  "[1] // trailing comment",
+};
+
+const std::vector<JsonBackend> kBackends = {JsonBackend::Jsoncpp, JsonBackend::Builtin};
+
+bool Parse(const JsonParserSettings& settings, const std::string& text, Json::Value& root)
+{
+  JsonParser parser(settings);
+  std::string errors;
+  return parser.Parse(text.data(), text.data() + text.size(), root, errors);
+}
+
+bool Parse(JsonBackend backend, const std::string& text, Json::Value& root)
+{
+  JsonParserSettings settings;
+  settings.backend = backend;
+  return Parse(settings, text, root);
+}
+
+/**
+ * @brief Make depth arrays nested in each other around a value.
+ */
+std::string Nest(size_t depth, const std::string& value)
+{
+  return std::string(depth, '[') + value + std::string(depth, ']');
+}
+}
+
+TEST_CASE("backends agree on valid documents")
+{
+  for (const std::string& text : kValid) {
+    Json::Value expected;
+    Json::Value actual;
+    bool jsoncpp = Parse(JsonBackend::Jsoncpp, text, expected);
+    bool builtin = Parse(JsonBackend::Builtin, text, actual);
+    CHECK(jsoncpp);
+    CHECK(builtin);
+    if (!(expected == actual)) {
+      std::printf("differs: %s\n", text.c_str());
+      CHECK(expected == actual);
+    }
+  }
+}
+
+TEST_CASE("backends agree on invalid documents")
+{
+  for (const std::string& text : kInvalid) {
+    Json::Value expected;
+    Json::Value actual;
+    bool jsoncpp = Parse(JsonBackend::Jsoncpp, text, expected);
+    bool builtin = Parse(JsonBackend::Builtin, text, actual);
+    if (jsoncpp != builtin) {
+      std::printf("accepted by one backend only: %s\n", text.c_str());
+      CHECK(jsoncpp == builtin);
+    }
+  }
+}
+
+TEST_CASE("builtin backend rejects what only jsoncpp accepts")
+{
+  for (const std::string& text : kLenient) {
+    Json::Value root;
+    CHECK(!Parse(JsonBackend::Builtin, text, root));
+  }
+}
+
+TEST_CASE("numbers too small for a double read as signed zero")
+{
+  Json::Value root;
+  CHECK(Parse(JsonBackend::Builtin, "[1e-400, -1e-400, -0.000001e-999]", root));
+  CHECK(root[0].asDouble() == 0.0 && !std::signbit(root[0].asDouble()));
+  CHECK(root[1].asDouble() == 0.0 && std::signbit(root[1].asDouble()));
+  CHECK(root[2].asDouble() == 0.0 && std::signbit(root[2].asDouble()));
+}
+
+TEST_CASE("backends apply the same depth limit")
+{
+  for (JsonBackend backend : kBackends) {
+    JsonParserSettings settings;
+    settings.backend = backend;
+    settings.depthLimit = 4;
+    Json::Value root;
+    CHECK(Parse(settings, Nest(4, "1"), root));
+    CHECK(Parse(settings, Nest(4, ""), root));
+    CHECK(Parse(settings, "{\"a\": {\"b\": {\"c\": {\"d\": 1}}}}", root));
+    CHECK(!Parse(settings, Nest(5, "1"), root));
+    CHECK(!Parse(settings, Nest(6, ""), root));
+    CHECK(!Parse(settings, "{\"a\": {\"b\": {\"c\": {\"d\": {\"e\": 1}}}}}", root));
+  }
+}
+
+TEST_CASE("strict mode rejects comments, trailing commas and extra text on both backends")
+{
+  for (JsonBackend backend : kBackends) {
+    JsonParserSettings settings;
+    settings.backend = backend;
+    settings.strict = true;
+    for (const std::string& text : kStrictRejects) {
+      Json::Value root;
+      CHECK(!Parse(settings, text, root));
+    }
+  }
+}
+
+TEST_CASE("without strict mode only jsoncpp accepts comments, trailing commas and extra text")
+{
+  for (const std::string& text : kStrictRejects) {
+    Json::Value root;
+    CHECK(Parse(JsonBackend::Jsoncpp, text, root));
+    CHECK(!Parse(JsonBackend::Builtin, text, root));
+  }
+}
+
+TEST_CASE("both backends reject duplicate keys when asked to")
+{
+  for (JsonBackend backend : kBackends) {
+    JsonParserSettings settings;
+    settings.backend = backend;
+    Json::Value root;
+    CHECK(Parse(settings, "{\"a\": 1, \"a\": 2}", root));
+    CHECK(root["a"].asInt() == 2);
+
+    settings.rejectDuplicateKeys = true;
+    CHECK(!Parse(settings, "{\"a\": 1, \"a\": 2}", root));
+    CHECK(!Parse(settings, "[{\"b\": {\"a\": 1, \"a\": 2}}]", root));
+    CHECK(Parse(settings, "{\"a\": 1, \"b\": {\"a\": 2}}", root));
+  }
+}
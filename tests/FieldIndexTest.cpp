@@ -0,0 +1,106 @@
+#include <stdexcept>
+#include <string>
+
+#include "JsonFields.h"
+#include "Test.h"
+#include "ValidatedJson.h"
+
+// Matching member names to declared fields through the compile-time perfect
+// hash: every key is found, and no other name is.
+
+namespace
+{
+class Record : public ValidatedJson
+{
+public:
+  Record(JsonData&& data) :
+    ValidatedJson(std::move(data))
+  {
+    Bind(*this);
+  }
+
+  static constexpr auto Fields()
+  {
+    return FieldList(Required("id", &Record::_id),
+                     Optional("", &Record::_empty, 0),
+                     Optional("name", &Record::_name, ""),
+                     Optional("description_of_record", &Record::_description, ""),
+                     Optional("a/b~c", &Record::_escaped, 0));
+  }
+
+private:
+  int _id = 0;
+  int _empty = 0;
+  std::string _name;
+  std::string _description;
+  int _escaped = 0;
+};
+
+using Index = FieldIndex<Record>;
+using Hash = PerfectHash<decltype(Record::Fields())::kSize>;
+
+inline int Find(const std::string& name)
+{
+  return Index::Find(name.data(), name.size());
+}
+
+/**
+ * @brief Find a name which is not a key but lands in the same bucket, and so
+ *        is checked against the same slot, as the given key.
+ */
+std::string SameBucketName(const std::string& key)
+{
+  uint64_t bucket = HashKey(key.data(), key.size()) & Hash::kMask;
+  for (int i = 0;; i++) {
+    std::string name = "other" + std::to_string(i);
+    if ((HashKey(name.data(), name.size()) & Hash::kMask) == bucket) {
+      return name;
+    }
+  }
+}
+}
+
+TEST_CASE("every declared key is found at its position")
+{
+  CHECK(Find("id") == 0);
+  CHECK(Find("") == 1);
+  CHECK(Find("name") == 2);
+  CHECK(Find("description_of_record") == 3);
+  CHECK(Find("a/b~c") == 4);
+}
+
+TEST_CASE("names which are not declared are not found")
+{
+  CHECK(Find("undeclared") == -1);
+  CHECK(Find("ID") == -1);
+  CHECK(Find(" id") == -1);
+}
+
+TEST_CASE("names which nearly match a key are not found")
+{
+  // Prefixes, extensions and a difference in the last byte, including past
+  // the first eight bytes which are hashed as one word
+  CHECK(Find("nam") == -1);
+  CHECK(Find("names") == -1);
+  CHECK(Find("namf") == -1);
+  CHECK(Find("description_of_recorD") == -1);
+  CHECK(Find("description_of_recor") == -1);
+  CHECK(Find(std::string("id\0", 3)) == -1);
+  // Only the given length is looked at
+  CHECK(Index::Find("identity", 2) == 0);
+  CHECK(Index::Find("name", 0) == 1);
+}
+
+TEST_CASE("names hashed to the same bucket as a key are not found")
+{
+  for (const char* key : {"id", "", "name", "description_of_record", "a/b~c"}) {
+    std::string name = SameBucketName(key);
+    CHECK(Find(name) == -1);
+  }
+}
+
+TEST_CASE("a key declared twice is rejected")
+{
+  std::array<FieldKey, 3> keys{{{"a", 1, 0}, {"b", 1, 1}, {"a", 1, 2}}};
+  CHECK_THROWS(PerfectHash<3>{keys}, std::logic_error);
+}
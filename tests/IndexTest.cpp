@@ -0,0 +1,194 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "JsonIndex.h"
+#include "JsonParser.h"
+#include "Test.h"
+
+// The structural index of every kernel against a byte-at-a-time reference.
+
+namespace
+{
+const JsonIndex::Kernel kKernels[] = {
+  JsonIndex::Kernel::Scalar, JsonIndex::Kernel::Sse42, JsonIndex::Kernel::Avx2
+};
+
+/**
+ * @brief Index text one byte at a time, as the kernels do a block at a time.
+ * @return Structural positions, followed by the length of the text.
+ */
+std::vector<uint32_t> ReferenceIndex(const std::string& text, bool& closed)
+{
+  std::vector<uint32_t> positions;
+  bool inString = false;
+  bool escaped = false;
+  bool followsScalar = false;
+  for (uint32_t i = 0; i < text.size(); i++) {
+    char c = text[i];
+    bool op = c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',';
+    bool whitespace = c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    // A backslash escapes the next byte inside or outside a string
+    bool quote = c == '"' && !escaped;
+    escaped = c == '\\' && !escaped;
+    bool scalar = !op && !whitespace;
+    if (inString) {
+      inString = !quote;
+    } else {
+      if (op || (scalar && !followsScalar)) {
+        positions.push_back(i);
+      }
+      inString = quote;
+    }
+    followsScalar = scalar && !quote;
+  }
+  positions.push_back(static_cast<uint32_t>(text.size()));
+  closed = !inString;
+  return positions;
+}
+
+/**
+ * @brief Check the index of every supported kernel against the reference.
+ */
+bool IndexMatches(const std::string& text)
+{
+  bool expectedClosed;
+  std::vector<uint32_t> expected = ReferenceIndex(text, expectedClosed);
+  for (JsonIndex::Kernel kernel : kKernels) {
+    if (!JsonIndex::Supported(kernel)) {
+      continue;
+    }
+    JsonIndex index;
+    bool closed = index.Build(text.data(), text.size(), kernel);
+    std::vector<uint32_t> actual(index.Positions(), index.Positions() + index.Size() + 1);
+    if (closed != expectedClosed || actual != expected) {
+      std::printf("kernel %d differs on: %s\n", static_cast<int>(kernel), text.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Make text from the bytes which matter to the index, weighted
+ *        towards quotes and backslashes so that escapes cross blocks.
+ */
+std::string RandomText(std::mt19937& random, size_t size)
+{
+  static const char kAlphabet[] = "{}[]:,\"\"\"\\\\\\  \t\n\rabtfn0123-.e\xc3\xa9";
+  std::uniform_int_distribution<size_t> pick(0, sizeof(kAlphabet) - 2);
+  std::string text;
+  for (size_t i = 0; i < size; i++) {
+    text += kAlphabet[pick(random)];
+  }
+  return text;
+}
+
+/**
+ * @brief Make a valid document of nested objects, arrays and scalars.
+ */
+std::string RandomDocument(std::mt19937& random, int depth)
+{
+  static const char* const kScalars[] = {
+    "0", "-12.5e3", "true", "false", "null", "\"\"", "\"a\\\"b\"", "\"\\\\\"",
+    "\"\\\\\\\"\\\\\"", "\"[{,:}]\"", "\"caf\xc3\xa9\"", "12345678901234567890"
+  };
+  static const char* const kKeys[] = {"\"k\"", "\"\"", "\"\\\"\"", "\"}:\""};
+  std::uniform_int_distribution<int> kind(0, depth > 0 ? 3 : 1);
+  std::uniform_int_distribution<int> count(0, 6);
+  std::uniform_int_distribution<size_t> scalar(0, sizeof(kScalars) / sizeof(kScalars[0]) - 1);
+  std::uniform_int_distribution<size_t> key(0, sizeof(kKeys) / sizeof(kKeys[0]) - 1);
+  std::uniform_int_distribution<int> spaces(0, 3);
+  std::string space(spaces(random), ' ');
+  switch (kind(random)) {
+    case 2: {
+      std::string text = "[" + space;
+      for (int i = count(random); i > 0; i--) {
+        text += RandomDocument(random, depth - 1) + (i > 1 ? "," + space : "");
+      }
+      return text + "]";
+    }
+    case 3: {
+      std::string text = "{" + space;
+      for (int i = count(random); i > 0; i--) {
+        text += std::string(kKeys[key(random)]) + space + ":" + RandomDocument(random, depth - 1) +
+                (i > 1 ? "," : "");
+      }
+      return text + space + "}";
+    }
+    default:
+      return kScalars[scalar(random)];
+  }
+}
+}
+
+TEST_CASE("index of a small document")
+{
+  const std::string text = "{\"a\": [1, true, \"x\\\"]\"], \"b\":null}";
+  JsonIndex index;
+  CHECK(index.Build(text.data(), text.size(), JsonIndex::Kernel::Scalar));
+  std::vector<uint32_t> positions(index.Positions(), index.Positions() + index.Size() + 1);
+  CHECK((positions == std::vector<uint32_t>{0, 1, 4, 6, 7, 8, 10, 14, 16, 22, 23, 25, 28, 29, 33,
+                                            static_cast<uint32_t>(text.size())}));
+}
+
+TEST_CASE("every kernel matches the reference on random bytes")
+{
+  std::mt19937 random(15);
+  for (size_t size = 0; size < 300; size++) {
+    CHECK(IndexMatches(RandomText(random, size)));
+  }
+  for (int i = 0; i < 200; i++) {
+    CHECK(IndexMatches(RandomText(random, 4096)));
+  }
+}
+
+TEST_CASE("every kernel matches the reference on escapes across blocks")
+{
+  for (size_t backslashes = 0; backslashes < 70; backslashes++) {
+    for (size_t offset = 50; offset < 70; offset++) {
+      std::string text = "[" + std::string(offset, ' ') + "\"" + std::string(backslashes, '\\') +
+                         "\"x\", 1]";
+      CHECK(IndexMatches(text));
+    }
+  }
+}
+
+TEST_CASE("every kernel matches the reference on documents")
+{
+  std::mt19937 random(150);
+  for (int i = 0; i < 300; i++) {
+    CHECK(IndexMatches(RandomDocument(random, 4)));
+  }
+}
+
+TEST_CASE("unclosed strings are reported by every kernel")
+{
+  for (JsonIndex::Kernel kernel : kKernels) {
+    if (JsonIndex::Supported(kernel)) {
+      JsonIndex index;
+      const std::string text = "{\"a\": \"" + std::string(100, 'x');
+      CHECK(!index.Build(text.data(), text.size(), kernel));
+    }
+  }
+}
+
+TEST_CASE("reading with the index gives the same tree as without")
+{
+  std::mt19937 random(1500);
+  JsonParserSettings settings;
+  settings.backend = JsonBackend::Builtin;
+  JsonParser plain(settings);
+  settings.structuralIndex = true;
+  JsonParser indexed(settings);
+  for (int i = 0; i < 300; i++) {
+    std::string text = RandomDocument(random, 4);
+    Json::Value expected;
+    Json::Value actual;
+    std::string errors;
+    CHECK(plain.Parse(text.data(), text.data() + text.size(), expected, errors));
+    CHECK(indexed.Parse(text.data(), text.data() + text.size(), actual, errors));
+    CHECK(expected == actual);
+  }
+}
@@ -0,0 +1,95 @@
+#include <cstdint>
+#include <string>
+
+#include "Test.h"
+#include "ValidatedJson.h"
+
+// Fixed-width integers are range checked, and a value out of range leaves
+// the field as it was.
+
+namespace
+{
+/**
+ * @brief Listener whose fields start at their defaults, and which hands
+ *        them out from its constructor so they can be seen on failure.
+ */
+class Listener : public ValidatedJson
+{
+public:
+  struct Seen
+  {
+    uint16_t port;
+    int8_t priority;
+    uint64_t limit;
+  };
+
+  Listener(JsonData&& data, Seen* seen) :
+    ValidatedJson(std::move(data))
+  {
+    Bind(*this);
+    *seen = Seen{_port, _priority, _limit};
+  }
+
+  static constexpr auto Fields()
+  {
+    return FieldList(Optional("port", &Listener::_port, uint16_t(8080)),
+                     Optional("priority", &Listener::_priority, int8_t(-1)),
+                     Optional("limit", &Listener::_limit, uint64_t(100)));
+  }
+
+private:
+  uint16_t _port = 8080;
+  int8_t _priority = -1;
+  uint64_t _limit = 100;
+};
+
+const char* kOutOfRange = "{\"port\": 70000, \"priority\": 300, \"limit\": -1}";
+const char* kWholeOutOfRange = "{\"port\": 65536.0, \"priority\": -129.0, \"limit\": 1e20}";
+const char* kInRange = "{\"port\": 65535, \"priority\": -128, \"limit\": 18446744073709551615}";
+
+// Fixed-width integers are numbers, even those which are character types
+// underneath, but bool and the character types are not
+static_assert(is_json_integer<int8_t>::value && is_json_integer<uint8_t>::value &&
+              is_json_integer<int64_t>::value && is_json_integer<uint64_t>::value);
+static_assert(!is_json_integer<bool>::value && !is_json_integer<char>::value &&
+              !is_json_integer<wchar_t>::value && !is_json_integer<char16_t>::value &&
+              !is_json_integer<char32_t>::value);
+}
+
+TEST_CASE("out of range optional fields keep their defaults")
+{
+  for (const char* json : {kOutOfRange, kWholeOutOfRange}) {
+    for (bool text : {false, true}) {
+      Listener::Seen seen{};
+      ValidationResult<Listener> result = text ? Validate<Listener>(JsonText(json), ValidationMode::AllErrors, &seen)
+                                               : Validate<Listener>(JsonString(json), ValidationMode::AllErrors, &seen);
+      CHECK(!result.Ok() && result.Errors().size() == 3);
+      CHECK(seen.port == 8080);
+      CHECK(seen.priority == -1);
+      CHECK(seen.limit == 100);
+    }
+  }
+}
+
+TEST_CASE("values at the limits of each type are bound")
+{
+  for (bool text : {false, true}) {
+    Listener::Seen seen{};
+    ValidationResult<Listener> result = text ? Validate<Listener>(JsonText(kInRange), ValidationMode::AllErrors, &seen)
+                                             : Validate<Listener>(JsonString(kInRange), ValidationMode::AllErrors, &seen);
+    CHECK(result.Ok());
+    CHECK(seen.port == 65535);
+    CHECK(seen.priority == -128);
+    CHECK(seen.limit == UINT64_MAX);
+  }
+}
+
+TEST_CASE("errors name the range of the type")
+{
+  Listener::Seen seen{};
+  ValidationResult<Listener> result = Validate<Listener>(JsonString("{\"port\": -1}"), ValidationMode::FirstError,
+                                                         &seen);
+  CHECK(!result.Ok());
+  CHECK(result.Errors()[0].message == "Expected integer value from 0 to 65535 for key: port");
+  CHECK(result.Errors()[0].path == "/port");
+}
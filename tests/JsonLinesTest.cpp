@@ -0,0 +1,110 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "JsonLinesFile.h"
+#include "MyData.h"
+#include "Test.h"
+
+// Lines and records read from a file through buffers of every small size.
+
+namespace
+{
+// Bound with Required(), which reads its object into a tree
+class Person : public ValidatedJson
+{
+public:
+  Person(JsonData&& data) :
+    ValidatedJson(std::move(data))
+  {
+    Required("name", _name);
+  }
+
+  std::string _name;
+};
+
+std::string Record(size_t age)
+{
+  return "{\"description\": \"line " + std::to_string(age) + "\", \"nested\": {\"age\": " +
+         std::to_string(age) + "}, \"values\": [" + std::to_string(age) + "]}";
+}
+}
+
+TEST_CASE("LineReader returns every line whatever the buffer size")
+{
+  std::mt19937 random(19);
+  std::uniform_int_distribution<int> length(0, 40);
+  std::vector<std::string> lines;
+  std::string content;
+  for (int i = 0; i < 200; i++) {
+    std::string line(length(random), static_cast<char>('a' + i % 26));
+    lines.push_back(line);
+    content += line + (i % 3 == 0 ? "\r\n" : "\n");
+  }
+  lines.push_back("no newline at the end");
+  content += lines.back();
+  TempFile file(content);
+
+  for (size_t bufferSize : {1, 2, 3, 7, 64, 4096}) {
+    LineReader reader(file.Path(), bufferSize);
+    std::string_view line;
+    size_t count = 0;
+    while (reader.NextLine(line)) {
+      CHECK(count < lines.size() && line == lines[count]);
+      count++;
+      CHECK(reader.LineNumber() == count);
+    }
+    CHECK(count == lines.size());
+  }
+}
+
+TEST_CASE("records are bound with their line numbers, skipping blank lines")
+{
+  TempFile file(Record(1) + "\n\n   \n" + Record(4) + "\r\n{\"description\": 5}\n{broken\n" + Record(7));
+  for (size_t bufferSize : {1, 16, 1 << 20}) {
+    JsonLinesFile<MyData> records(file.Path(), ValidationMode::FirstError, JsonParser::ThreadLocal(),
+                                  bufferSize);
+    std::vector<size_t> numbers;
+    std::vector<bool> ok;
+    while (auto record = records.Next()) {
+      numbers.push_back(record->number);
+      ok.push_back(record->result.Ok());
+      if (record->result.Ok()) {
+        CHECK(record->result.Value().ToString() == MyData{JsonString(Record(record->number))}.ToString());
+      }
+    }
+    CHECK((numbers == std::vector<size_t>{1, 4, 5, 6, 7}));
+    CHECK((ok == std::vector<bool>{true, true, false, false, true}));
+  }
+}
+
+TEST_CASE("an empty file has no records")
+{
+  TempFile file("");
+  JsonLinesFile<MyData> records(file.Path());
+  CHECK(!records.Next());
+}
+
+TEST_CASE("a missing file cannot be opened")
+{
+  CHECK_THROWS(LineReader("/nonexistent/lines.ndjson"), std::runtime_error);
+}
+
+TEST_CASE("a line which is not an object is reported and reading carries on")
+{
+  TempFile file("{\"name\": \"a\"}\n[1]\n42\n\"s\"\nnull\n{\"name\": \"b\"}\n");
+  JsonLinesFile<Person> records(file.Path(), ValidationMode::AllErrors);
+  std::vector<size_t> numbers;
+  std::vector<std::string> names;
+  while (auto record = records.Next()) {
+    numbers.push_back(record->number);
+    if (record->result.Ok()) {
+      names.push_back(record->result.Value()._name);
+    } else {
+      CHECK(record->result.Errors().size() == 1);
+      CHECK(record->result.Errors()[0].message == "Required key \"name\" not found");
+    }
+  }
+  CHECK((numbers == std::vector<size_t>{1, 2, 3, 4, 5, 6}));
+  CHECK((names == std::vector<std::string>{"a", "b"}));
+}
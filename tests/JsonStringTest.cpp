@@ -0,0 +1,127 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "MyData.h"
+#include "Test.h"
+
+// JsonString parses text where it lies: a buffer needs no terminating null,
+// nothing past its end is read, and the text is not copied.
+
+namespace
+{
+std::atomic<size_t> allocBytes{0};
+
+const std::string kDocument =
+  "{\"name\": \"raw\", \"description\": \"d\", \"nested\": {\"age\": 9}, \"values\": [1, 2]}";
+
+/**
+ * @brief Buffer which ends at the end of a page, followed by a page which
+ *        can't be read, so reading past the end of the text faults.
+ */
+class GuardedBuffer
+{
+public:
+  explicit GuardedBuffer(const std::string& text)
+  {
+    size_t page = sysconf(_SC_PAGESIZE);
+    _mappingSize = ((text.size() + page - 1) / page + 1) * page;
+    void* address = mmap(nullptr, _mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (address == MAP_FAILED) {
+      throw std::runtime_error("Could not map a guarded buffer");
+    }
+    _mapping = static_cast<char*>(address);
+    mprotect(_mapping + _mappingSize - page, page, PROT_NONE);
+    _data = _mapping + _mappingSize - page - text.size();
+    std::memcpy(_data, text.data(), text.size());
+    _size = text.size();
+  }
+
+  ~GuardedBuffer() { munmap(_mapping, _mappingSize); }
+
+  GuardedBuffer(const GuardedBuffer&) = delete;
+  GuardedBuffer& operator=(const GuardedBuffer&) = delete;
+
+  const char* Data() const { return _data; }
+  size_t Size() const { return _size; }
+
+private:
+  char* _mapping = nullptr;
+  size_t _mappingSize = 0;
+  char* _data = nullptr;
+  size_t _size = 0;
+};
+
+JsonParser MakeParser(JsonBackend backend, bool strict = false)
+{
+  JsonParserSettings settings;
+  settings.backend = backend;
+  settings.strict = strict;
+  return JsonParser(settings);
+}
+}
+
+// Count the bytes allocated, to see that the text is not copied
+void* operator new(size_t size)
+{
+  allocBytes.fetch_add(size, std::memory_order_relaxed);
+  void* ptr = std::malloc(size ? size : 1);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+TEST_CASE("a raw buffer binds without a terminating null")
+{
+  GuardedBuffer buffer(kDocument);
+  std::string expected = MyData{JsonString(kDocument)}.ToString();
+  for (JsonBackend backend : {JsonBackend::Jsoncpp, JsonBackend::Builtin}) {
+    JsonParser parser = MakeParser(backend);
+    MyData data{JsonString(buffer.Data(), buffer.Size(), parser)};
+    CHECK(data.ToString() == expected);
+  }
+}
+
+TEST_CASE("only the given length of a buffer is parsed")
+{
+  // A complete document followed by text which a strict parser rejects
+  std::string text = kDocument + "} not JSON";
+  std::string expected = MyData{JsonString(kDocument)}.ToString();
+  for (JsonBackend backend : {JsonBackend::Jsoncpp, JsonBackend::Builtin}) {
+    JsonParser parser = MakeParser(backend, true);
+    MyData data{JsonString(text.data(), kDocument.size(), parser)};
+    CHECK(data.ToString() == expected);
+    CHECK_THROWS(JsonString(text.data(), text.size(), parser), std::runtime_error);
+  }
+}
+
+TEST_CASE("the text is parsed without being copied")
+{
+  // Mostly whitespace, so a copy would allocate far more than the tree
+  std::string text = std::string(1 << 20, ' ') + kDocument;
+  std::string expected = MyData{JsonString(kDocument)}.ToString();
+  for (JsonBackend backend : {JsonBackend::Jsoncpp, JsonBackend::Builtin}) {
+    JsonParser parser = MakeParser(backend);
+    size_t before = allocBytes.load();
+    {
+      MyData data{JsonString(text.data(), text.size(), parser)};
+      CHECK(data.ToString() == expected);
+    }
+    CHECK(allocBytes.load() - before < 64 * 1024);
+    before = allocBytes.load();
+    {
+      JsonString data{std::string_view(text), parser};
+    }
+    CHECK(allocBytes.load() - before < 64 * 1024);
+  }
+}
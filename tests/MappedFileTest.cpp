@@ -0,0 +1,97 @@
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MappedFile.h"
+#include "MyData.h"
+#include "Test.h"
+
+// Mapping regular files, reading everything else, and failing cleanly on
+// what can't be read.
+
+namespace
+{
+const std::string kDocument =
+  "{\"description\": \"d\", \"nested\": {\"age\": 7}, \"values\": [1, 2, 3]}";
+
+/**
+ * @brief Named pipe beside a temporary file, which is written to from
+ *        another thread once it is opened for reading.
+ */
+class Fifo
+{
+public:
+  explicit Fifo(const std::string& content) :
+    _path(_file.Path() + ".fifo")
+  {
+    if (mkfifo(_path.c_str(), 0600) != 0) {
+      throw std::runtime_error("Could not create FIFO: " + _path);
+    }
+    // Opening for writing waits for the reader
+    _writer = std::thread([this, content] { std::ofstream(_path, std::ios::binary) << content; });
+  }
+
+  ~Fifo()
+  {
+    _writer.join();
+    std::remove(_path.c_str());
+  }
+
+  const std::string& Path() const { return _path; }
+
+private:
+  TempFile _file{""};
+  std::string _path;
+  std::thread _writer;
+};
+}
+
+TEST_CASE("regular files are mapped")
+{
+  TempFile file(kDocument);
+  MappedFile mapped(file.Path());
+  CHECK(mapped.IsMapped());
+  CHECK(std::string(mapped.Data(), mapped.Size()) == kDocument);
+}
+
+TEST_CASE("FIFOs are read rather than mapped")
+{
+  // Longer than one read() chunk
+  std::string content(200 * 1024, ' ');
+  content += kDocument;
+  {
+    Fifo fifo(content);
+    MappedFile read(fifo.Path());
+    CHECK(!read.IsMapped());
+    CHECK(std::string(read.Data(), read.Size()) == content);
+  }
+  {
+    Fifo fifo(kDocument);
+    MyData data{JsonFile(fifo.Path())};
+    CHECK(data.ToString() == MyData{JsonString(kDocument)}.ToString());
+  }
+}
+
+TEST_CASE("empty files are read as no text")
+{
+  TempFile file("");
+  MappedFile empty(file.Path());
+  CHECK(!empty.IsMapped());
+  CHECK(empty.Size() == 0);
+  CHECK_THROWS(JsonFile{file.Path()}, std::runtime_error);
+}
+
+TEST_CASE("missing files and directories can't be read")
+{
+  TempFile file("");
+  std::string missing = file.Path() + ".missing";
+  CHECK_THROWS(MappedFile{missing}, std::runtime_error);
+  CHECK_THROWS(JsonFile{missing}, std::runtime_error);
+  CHECK_THROWS(MappedFile{"/tmp"}, std::runtime_error);
+  CHECK_THROWS(JsonFile{"/tmp"}, std::runtime_error);
+}
@@ -0,0 +1,135 @@
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "JsonReader.h"
+#include "Test.h"
+
+// JsonReader::ReadNumber() against std::from_chars on random numbers.
+
+namespace
+{
+/**
+ * @brief Make a random number in JSON syntax: integers of up to 25 digits,
+ *        fractions, and exponents both inside and outside the fast path,
+ *        down to underflow but never up to overflow.
+ */
+std::string RandomNumber(std::mt19937_64& random)
+{
+  std::uniform_int_distribution<int> digitCount(1, 25);
+  std::uniform_int_distribution<int> digit(0, 9);
+  std::uniform_int_distribution<int> form(0, 5);
+  std::uniform_int_distribution<int> smallExponent(-30, 30);
+  std::uniform_int_distribution<int> largeExponent(-360, 280);
+
+  std::string number = random() & 1 ? "-" : "";
+  auto digits = [&](int count, bool leading) {
+    for (int i = 0; i < count; i++) {
+      int d = digit(random);
+      number += static_cast<char>('0' + (leading && i == 0 && count > 1 && d == 0 ? 1 : d));
+    }
+  };
+  int shape = form(random);
+  digits(shape == 0 ? 1 : digitCount(random), true);
+  if (shape >= 2) {
+    number += '.';
+    digits(digitCount(random), false);
+  }
+  if (shape >= 3) {
+    number += random() & 1 ? 'e' : 'E';
+    int exponent = shape == 5 ? largeExponent(random) : smallExponent(random);
+    number += exponent < 0 ? "-" : random() & 1 ? "+" : "";
+    number += std::to_string(exponent < 0 ? -exponent : exponent);
+  }
+  return number;
+}
+
+/**
+ * @brief Check one number read by the reader against from_chars.
+ */
+bool NumberMatches(const std::string& text, const JsonNumber& number)
+{
+  const char* begin = text.data();
+  const char* end = begin + text.size();
+  double expected = 0;
+  auto [position, error] = std::from_chars(begin, end, expected);
+  if (error == std::errc::result_out_of_range) {
+    // Only underflow is generated; it reads as a zero of the same sign
+    expected = text[0] == '-' ? -0.0 : 0.0;
+  }
+  bool same = std::memcmp(&expected, &number.real, sizeof(double)) == 0;
+
+  // An integer is kept as one if its magnitude fits int64_t, or uint64_t
+  // when it is positive
+  bool negative = text[0] == '-';
+  uint64_t magnitude;
+  bool integer = text.find_first_of(".eE") == std::string::npos &&
+                 std::from_chars(begin + negative, end, magnitude).ec == std::errc() &&
+                 (!negative || magnitude <= (uint64_t(1) << 63));
+  if (integer) {
+    same = same && number.integer && number.negative == negative && number.magnitude == magnitude;
+  } else {
+    same = same && !number.integer;
+  }
+  if (!same) {
+    std::printf("differs: %s read as %.17g\n", text.c_str(), number.real);
+  }
+  return same;
+}
+}
+
+TEST_CASE("ReadNumber() matches from_chars on two million random numbers")
+{
+  std::mt19937_64 random(17);
+  for (int batch = 0; batch < 20; batch++) {
+    std::vector<std::string> numbers;
+    std::string text = "[";
+    for (int i = 0; i < 100000; i++) {
+      numbers.push_back(RandomNumber(random));
+      text += (i ? "," : "") + numbers.back();
+    }
+    text += "]";
+
+    JsonReader reader(text.data(), text.data() + text.size());
+    reader.BeginArray();
+    size_t differences = 0;
+    for (const std::string& number : numbers) {
+      CHECK(reader.NextElement());
+      differences += !NumberMatches(number, reader.ReadNumber());
+      if (differences > 10) {
+        break;
+      }
+    }
+    CHECK(differences == 0);
+  }
+}
+
+TEST_CASE("integer limits are read exactly")
+{
+  const std::vector<std::string> texts = {
+    "0", "-0", "9007199254740993", "-9007199254740993", "9223372036854775807",
+    "-9223372036854775808", "18446744073709551615", "18446744073709551616",
+    "-9223372036854775809", "100000000000000000000000"
+  };
+  for (const std::string& text : texts) {
+    JsonReader reader(text.data(), text.data() + text.size());
+    CHECK(NumberMatches(text, reader.ReadNumber()));
+  }
+}
+
+TEST_CASE("numbers around the fast path limits are correctly rounded")
+{
+  const std::vector<std::string> texts = {
+    "9007199254740992e22", "9007199254740993e22", "9007199254740992e-22", "1e23", "1e-23",
+    "2.2250738585072011e-308", "2.2250738585072012e-308", "4.9406564584124654e-324",
+    "1.7976931348623157e308", "0.1", "0.30000000000000004", "123456789012345678901234567890e-10"
+  };
+  for (const std::string& text : texts) {
+    JsonReader reader(text.data(), text.data() + text.size());
+    CHECK(NumberMatches(text, reader.ReadNumber()));
+  }
+}
@@ -0,0 +1,113 @@
+#include <string>
+
+#include "Test.h"
+#include "ValidatedJson.h"
+
+// Members found by name in objects read from text, with and without onDemand.
+
+namespace
+{
+class Pair : public ValidatedJson
+{
+public:
+  Pair(JsonData&& data) :
+    ValidatedJson(std::move(data))
+  {
+    Required("first", _first);
+    Optional("second", _second, -1);
+  }
+
+  int First() const { return _first; }
+  int Second() const { return _second; }
+
+private:
+  int _first = 0;
+  int _second = 0;
+};
+
+class BoundPair : public ValidatedJson
+{
+public:
+  BoundPair(JsonData&& data) :
+    ValidatedJson(std::move(data))
+  {
+    Bind(*this);
+  }
+
+  static constexpr auto Fields()
+  {
+    return FieldList(Required("first", &BoundPair::_first),
+                     Optional("second", &BoundPair::_second, -1));
+  }
+
+  int First() const { return _first; }
+  int Second() const { return _second; }
+
+private:
+  int _first = 0;
+  int _second = 0;
+};
+
+JsonParserSettings Settings(bool onDemand, bool rejectDuplicateKeys = false)
+{
+  JsonParserSettings settings;
+  settings.onDemand = onDemand;
+  settings.rejectDuplicateKeys = rejectDuplicateKeys;
+  return settings;
+}
+
+/**
+ * @brief Make an object with many other members around "first" and "second".
+ */
+std::string MakeWide(size_t members)
+{
+  std::string json = "{";
+  for (size_t i = 0; i < members; i++) {
+    json += "\"k" + std::to_string(i) + "\": [" + std::to_string(i) + "], ";
+    if (i == members / 2) {
+      json += "\"second\": 2, ";
+    }
+  }
+  return json + "\"first\": 1}";
+}
+}
+
+TEST_CASE("members are found among many others")
+{
+  const std::string json = MakeWide(20000);
+  for (bool onDemand : {false, true}) {
+    Pair pair{JsonText(json, Settings(onDemand))};
+    CHECK(pair.First() == 1);
+    CHECK(pair.Second() == 2);
+    BoundPair bound{JsonText(json, Settings(onDemand))};
+    CHECK(bound.First() == 1);
+    CHECK(bound.Second() == 2);
+  }
+}
+
+TEST_CASE("missing members take their defaults or fail")
+{
+  for (bool onDemand : {false, true}) {
+    Pair pair{JsonText("{\"other\": 3, \"first\": 1}", Settings(onDemand))};
+    CHECK(pair.Second() == -1);
+    CHECK_THROWS(Pair{JsonText("{\"second\": 2}", Settings(onDemand))}, std::runtime_error);
+  }
+}
+
+TEST_CASE("the last of duplicate members wins unless duplicates are rejected")
+{
+  const std::string json = "{\"first\": 1, \"second\": 2, \"first\": 3}";
+  for (bool onDemand : {false, true}) {
+    CHECK(Pair{JsonText(json, Settings(onDemand))}.First() == 3);
+    CHECK(BoundPair{JsonText(json, Settings(onDemand))}.First() == 3);
+    CHECK_THROWS(Pair{JsonText(json, Settings(onDemand, true))}, JsonSyntaxError);
+  }
+}
+
+TEST_CASE("only onDemand skips members without checking their syntax")
+{
+  const std::string json = "{\"skipped\": [1, 2 3}, \"first\": 1}";
+  CHECK_THROWS(Pair{JsonText(json, Settings(false))}, JsonSyntaxError);
+  CHECK(Pair{JsonText(json, Settings(true))}.First() == 1);
+  CHECK(BoundPair{JsonText(json, Settings(true))}.First() == 1);
+}
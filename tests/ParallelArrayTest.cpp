@@ -0,0 +1,84 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Test.h"
+#include "ThreadPool.h"
+#include "ValidatedJson.h"
+
+// Arrays of nested objects are bound in order unless SetParallelArrays()
+// turns splitting on, and come out the same either way.
+
+namespace
+{
+std::atomic<size_t> boundElsewhere{0};
+std::thread::id caller;
+
+class Item : public ValidatedJson
+{
+public:
+  Item(JsonData&& data) :
+    ValidatedJson(std::move(data))
+  {
+    Required("id", _id);
+    if (std::this_thread::get_id() != caller) {
+      boundElsewhere++;
+    }
+  }
+
+  int Id() const { return _id; }
+
+private:
+  int _id = 0;
+};
+
+class Items : public ValidatedJson
+{
+public:
+  Items(JsonData&& data) :
+    ValidatedJson(std::move(data))
+  {
+    Required("items", _items);
+  }
+
+  const std::vector<Item>& Get() const { return _items; }
+
+private:
+  std::vector<Item> _items;
+};
+
+std::string MakeItems(size_t count, size_t bad)
+{
+  std::string json = "{\"items\": [";
+  for (size_t i = 0; i < count; i++) {
+    json += (i ? ", " : "") + (i == bad ? std::string("{\"id\": \"x\"}") : "{\"id\": " + std::to_string(i) + "}");
+  }
+  return json + "]}";
+}
+}
+
+TEST_CASE("large arrays are bound on the calling thread by default")
+{
+  caller = std::this_thread::get_id();
+  boundElsewhere = 0;
+  Items items{JsonString(MakeItems(100000, size_t(-1)))};
+  CHECK(items.Get().size() == 100000);
+  CHECK(boundElsewhere == 0);
+}
+
+TEST_CASE("split arrays bind as they do in order")
+{
+  caller = std::this_thread::get_id();
+  ThreadPool pool(4);
+  ValidatedJson::SetParallelArrays(100, &pool);
+
+  Items items{JsonString(MakeItems(5000, size_t(-1)))};
+  CHECK(items.Get().size() == 5000);
+  CHECK(items.Get()[4999].Id() == 4999);
+
+  ValidationResult<Items> first = Validate<Items>(JsonString(MakeItems(5000, 3210)));
+  CHECK(!first.Ok() && first.Errors().size() == 1 && first.Errors()[0].path == "/items/3210/id");
+
+  ValidatedJson::SetParallelArrays(0);
+}
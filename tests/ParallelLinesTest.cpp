@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "MyData.h"
+#include "ParallelJsonLines.h"
+#include "Test.h"
+
+// ParallelJsonLines against JsonLinesFile on the same file, on pools of one
+// and several threads and from a task of the pool itself.
+
+namespace
+{
+/**
+ * @brief Make lines of valid, invalid and blank records, some ending in CRLF.
+ */
+std::string MakeLines(size_t count)
+{
+  std::string content;
+  for (size_t i = 0; i < count; i++) {
+    const std::string n = std::to_string(i);
+    switch (i % 7) {
+      case 3:
+        content += "{\"description\": " + n + "}";
+        break;
+      case 5:
+        content += "  ";
+        break;
+      case 6:
+        content += "{\"description\": \"" + n + "\", \"nested\": ";
+        break;
+      default:
+        content += "{\"description\": \"" + n + "\", \"nested\": {\"age\": " + n + "}, \"values\": [" + n + "]}";
+    }
+    content += i % 2 ? "\r\n" : "\n";
+  }
+  return content + "{\"description\": \"last\", \"nested\": {\"age\": 0}, \"values\": []}";
+}
+
+/**
+ * @brief Describe a record by its line number and value or first error.
+ */
+std::string Describe(const JsonLine<MyData>& line)
+{
+  return std::to_string(line.number) + ": " +
+         (line.result.Ok() ? line.result.Value().ToString() : line.result.Errors()[0].message);
+}
+
+std::vector<std::string> ReadSerially(const std::string& path)
+{
+  std::vector<std::string> lines;
+  JsonLinesFile<MyData> file(path);
+  while (auto line = file.Next()) {
+    lines.push_back(Describe(*line));
+  }
+  return lines;
+}
+
+std::vector<std::string> ReadInParallel(const std::string& path, ThreadPool& pool, LineOrder order,
+                                        size_t chunkSize)
+{
+  std::vector<std::string> lines;
+  ParallelJsonLines<MyData> file(path, pool, order, ValidationMode::FirstError, JsonParser::ThreadLocal(),
+                                 chunkSize);
+  file.ForEach([&](JsonLine<MyData>&& line) { lines.push_back(Describe(line)); });
+  return lines;
+}
+}
+
+TEST_CASE("records match JsonLinesFile in file order or as a set")
+{
+  TempFile file(MakeLines(3000));
+  const std::vector<std::string> expected = ReadSerially(file.Path());
+  std::vector<std::string> sorted = expected;
+  std::sort(sorted.begin(), sorted.end());
+
+  for (unsigned threads : {1, 3}) {
+    ThreadPool pool(threads);
+    for (size_t chunkSize : {1, 1000, 1 << 20}) {
+      CHECK(ReadInParallel(file.Path(), pool, LineOrder::Ordered, chunkSize) == expected);
+      std::vector<std::string> unordered = ReadInParallel(file.Path(), pool, LineOrder::Unordered, chunkSize);
+      std::sort(unordered.begin(), unordered.end());
+      CHECK(unordered == sorted);
+    }
+  }
+}
+
+TEST_CASE("ForEach() may be called from a task of the same pool")
+{
+  TempFile file(MakeLines(500));
+  const std::vector<std::string> expected = ReadSerially(file.Path());
+  for (unsigned threads : {1, 2}) {
+    ThreadPool pool(threads);
+    std::vector<std::vector<std::string>> read(2);
+    pool.Run(read.size(), [&](size_t i) {
+      read[i] = ReadInParallel(file.Path(), pool, LineOrder::Ordered, 100);
+    });
+    CHECK(read[0] == expected);
+    CHECK(read[1] == expected);
+  }
+}
+
+TEST_CASE("an exception from the callback ends ForEach()")
+{
+  TempFile file(MakeLines(2000));
+  ThreadPool pool(2);
+  ParallelJsonLines<MyData> lines(file.Path(), pool, LineOrder::Ordered, ValidationMode::FirstError,
+                                  JsonParser::ThreadLocal(), 64);
+  size_t seen = 0;
+  CHECK_THROWS(lines.ForEach([&](JsonLine<MyData>&&) {
+    if (++seen == 10) {
+      throw std::runtime_error("stop");
+    }
+  }), std::runtime_error);
+  CHECK(seen == 10);
+}
@@ -0,0 +1,218 @@
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "JsonPushParser.h"
+#include "MyData.h"
+#include "Test.h"
+
+// JsonPushParser fed in chunks down to single bytes, against the builtin
+// parser reading the whole buffer.
+
+namespace
+{
+const std::vector<std::string> kDocuments = {
+  "{}",
+  "[]",
+  "null",
+  "true",
+  "\"text\"",
+  "  \n\t{ \"a\" : [ 1 , 2 , { \"b\" : null } ] }  ",
+  "{\"nested\": {\"deeper\": {\"deepest\": [[], {}, [[[]]]]}}}",
+  "[true, false, null, \"\", \"text\"]",
+  "[\"\\\"\\\\\\/\\b\\f\\n\\r\\t\", \"\\u0041\\u00e9\\u20ac\", \"\\ud83d\\ude00\"]",
+  "[\"caf\xc3\xa9\", \"\xe2\x82\xac\", \"\xf0\x9f\x98\x80\"]",
+  "[0, -0, 1, -1, 2147483647, -2147483648, 4294967295, 4294967296]",
+  "[9223372036854775807, -9223372036854775808, 18446744073709551615]",
+  "[0.5, -0.25, 1e10, 1E-10, 1.5e+3, 3.141592653589793, 2.2250738585072014e-308]",
+  "[1.7976931348623157e308, 4.9e-324, 1e-400, -1e-400]",
+  "{\"duplicate\": 1, \"duplicate\": 2}",
+};
+
+const std::vector<std::string> kInvalid = {
+  "{\"a\" 1}",
+  "{\"a\": }",
+  "{1: 2}",
+  "[1 2]",
+  "[.5]",
+  "[1e]",
+  "[tru]",
+  "[nul1]",
+  "[\"\\x\"]",
+  "[\"\\u12\"]",
+  "[1e400]",
+  "]",
+};
+
+Json::Value ParseWhole(const std::string& text)
+{
+  JsonParserSettings settings;
+  settings.backend = JsonBackend::Builtin;
+  JsonParser parser(settings);
+  Json::Value root;
+  std::string errors;
+  CHECK(parser.Parse(text.data(), text.data() + text.size(), root, errors));
+  return root;
+}
+
+/**
+ * @brief Feed text to a push parser in chunks of the given size and take
+ *        every document it holds.
+ */
+std::vector<Json::Value> ParsePushed(const std::string& text, size_t chunkSize)
+{
+  JsonPushParser parser;
+  std::vector<Json::Value> documents;
+  for (size_t offset = 0; offset < text.size(); offset += chunkSize) {
+    std::string_view chunk = std::string_view(text).substr(offset, chunkSize);
+    while (!chunk.empty()) {
+      chunk.remove_prefix(parser.Feed(chunk));
+      if (parser.Done()) {
+        documents.push_back(parser.Take());
+      }
+    }
+  }
+  if (parser.Started()) {
+    parser.Finish();
+    documents.push_back(parser.Take());
+  }
+  return documents;
+}
+
+/**
+ * @brief Check whether feeding text in chunks of the given size fails as a
+ *        syntax error, from Feed() or Finish().
+ */
+bool PushFails(const std::string& text, size_t chunkSize)
+{
+  try {
+    ParsePushed(text, chunkSize);
+  } catch (const JsonSyntaxError&) {
+    return true;
+  }
+  return false;
+}
+}
+
+TEST_CASE("documents fed in chunks of any size match the whole buffer")
+{
+  for (const std::string& text : kDocuments) {
+    const Json::Value expected = ParseWhole(text);
+    for (size_t chunkSize : {1, 2, 3, 7, 4096}) {
+      std::vector<Json::Value> documents = ParsePushed(text, chunkSize);
+      if (documents.size() != 1 || !(documents[0] == expected)) {
+        std::printf("differs in chunks of %zu: %s\n", chunkSize, text.c_str());
+        CHECK(false);
+      }
+    }
+  }
+}
+
+TEST_CASE("documents one after another are taken in turn")
+{
+  std::string stream;
+  std::vector<Json::Value> expected;
+  for (const std::string& text : kDocuments) {
+    stream += text + "\n";
+    expected.push_back(ParseWhole(text));
+  }
+  stream += "-12.5e3 42";
+  expected.push_back(-12500.0);
+  expected.push_back(42);
+  for (size_t chunkSize : {1, 5, 4096}) {
+    CHECK(ParsePushed(stream, chunkSize) == expected);
+  }
+}
+
+TEST_CASE("a number at the top level is ended only by Finish()")
+{
+  JsonPushParser parser;
+  for (char c : std::string("-1234.5e-1")) {
+    CHECK(parser.Feed(&c, 1) == 1);
+  }
+  CHECK(!parser.Done());
+  parser.Finish();
+  CHECK(parser.Take() == Json::Value(-123.45));
+  CHECK(!parser.Started());
+}
+
+TEST_CASE("truncated and invalid documents throw")
+{
+  for (const std::string& text : kDocuments) {
+    if (text.find_first_of("[{") == std::string::npos) {
+      continue;
+    }
+    const size_t start = text.find_first_of("[{") + 1;
+    const size_t end = text.find_last_of("]}");
+    for (size_t length = start; length <= end; length++) {
+      CHECK(PushFails(text.substr(0, length), 1));
+    }
+  }
+  for (const std::string& text : kInvalid) {
+    CHECK(PushFails(text, 1));
+    CHECK(PushFails(text, 4096));
+  }
+}
+
+TEST_CASE("the parser is fed again after Reset()")
+{
+  JsonPushParser parser;
+  CHECK_THROWS(parser.Feed("[1 2]"), JsonSyntaxError);
+  parser.Reset();
+  CHECK(parser.Feed("[1, 2]") == 6);
+  CHECK(parser.Take() == ParseWhole("[1, 2]"));
+}
+
+TEST_CASE("JsonPushBinder binds what Validate binds")
+{
+  const std::vector<std::string> records = {
+    "{\"description\": \"first\", \"nested\": {\"age\": 1}, \"values\": [1]}",
+    "{\"name\": \"second\", \"description\": \"\", \"nested\": {\"age\": 2}, \"values\": []}",
+    "{\"description\": 3, \"nested\": {}, \"values\": [\"x\"]}",
+    "{\"description\": \"fourth\", \"nested\": {\"age\": 4}, \"values\": [4, 4]}",
+  };
+  std::string stream;
+  for (const std::string& record : records) {
+    stream += record + " ";
+  }
+
+  for (ValidationMode mode : {ValidationMode::FirstError, ValidationMode::AllErrors}) {
+    JsonPushBinder<MyData> binder(mode);
+    std::vector<ValidationResult<MyData>> results;
+    for (size_t offset = 0; offset < stream.size(); offset++) {
+      std::string_view chunk = std::string_view(stream).substr(offset, 1);
+      while (!chunk.empty()) {
+        if (auto result = binder.Feed(chunk)) {
+          results.push_back(std::move(*result));
+        }
+      }
+    }
+    CHECK(!binder.Finish());
+    CHECK(results.size() == records.size());
+    for (size_t i = 0; i < results.size() && i < records.size(); i++) {
+      ValidationResult<MyData> expected = Validate<MyData>(records[i], mode);
+      CHECK(results[i].Ok() == expected.Ok());
+      CHECK(results[i].Errors().size() == expected.Errors().size());
+      if (results[i].Ok() && expected.Ok()) {
+        CHECK(results[i].Value().ToString() == expected.Value().ToString());
+      }
+    }
+  }
+}
+
+TEST_CASE("JsonPushBinder ignores the rest of the input after a syntax error")
+{
+  JsonPushBinder<MyData> binder;
+  std::string_view chunk = "{\"description\" 1} {\"description\": \"x\", \"nested\": {\"age\": 1}, \"values\": []}";
+  auto result = binder.Feed(chunk);
+  CHECK(result && !result->Ok());
+  CHECK(chunk.empty());
+
+  chunk = "{\"description\": \"x\", \"nested\": {\"age\": 1}, \"values\": []}";
+  CHECK(!binder.Feed(chunk));
+  binder.Reset();
+  chunk = "{\"description\": \"x\", \"nested\": {\"age\": 1}, \"values\": []}";
+  result = binder.Feed(chunk);
+  CHECK(result && result->Ok());
+}
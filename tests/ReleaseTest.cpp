@@ -0,0 +1,56 @@
+#include <stdexcept>
+#include <string>
+
+#include "Test.h"
+#include "ValidatedJson.h"
+
+// Objects which release their document must not read it after construction.
+
+namespace
+{
+class Released : public ValidatedJson
+{
+public:
+  Released(JsonData&& data, JsonStorage storage = JsonStorage::Release) :
+    ValidatedJson(std::move(data), storage)
+  {
+    Required("age", _age);
+  }
+
+  int Age() const { return _age; }
+
+  // Binds again after construction, when the data is gone
+  void Rebind() { Required("age", _age); }
+
+private:
+  int _age = 0;
+};
+}
+
+TEST_CASE("released tree is not read after construction")
+{
+  Released object{JsonString("{\"age\": 7}")};
+  CHECK(object.Age() == 7);
+  CHECK_THROWS(object.Rebind(), std::logic_error);
+}
+
+TEST_CASE("text is not read after construction")
+{
+  Released object{JsonText("{\"age\": 8}")};
+  CHECK(object.Age() == 8);
+  CHECK_THROWS(object.Rebind(), std::logic_error);
+}
+
+TEST_CASE("validated object is not read after Validate")
+{
+  ValidationResult<Released> result = Validate<Released>(JsonString("{\"age\": 9}"));
+  CHECK(result.Ok());
+  CHECK_THROWS(result.Value().Rebind(), std::logic_error);
+}
+
+TEST_CASE("retained tree can still be bound after construction")
+{
+  Released object{JsonString("{\"age\": 10}"), JsonStorage::Retain};
+  object.Rebind();
+  CHECK(object.Age() == 10);
+}
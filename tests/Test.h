@@ -0,0 +1,144 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+// Minimal test harness: each test file defines its cases with TEST_CASE and
+// checks them with CHECK; TestMain() runs them all and sets the exit code.
+
+/**
+ * @brief A named test case.
+ */
+struct TestCase
+{
+  const char* name;
+  std::function<void()> run;
+};
+
+/**
+ * @brief Get the test cases registered in this executable.
+ * @return std::vector<TestCase>&
+ */
+inline std::vector<TestCase>& TestCases()
+{
+  static std::vector<TestCase> cases;
+  return cases;
+}
+
+/**
+ * @brief Get the number of failed checks so far.
+ * @return int&
+ */
+inline int& TestFailures()
+{
+  static int failures = 0;
+  return failures;
+}
+
+/**
+ * @brief Registers a test case at static initialisation.
+ */
+struct TestRegistrar
+{
+  TestRegistrar(const char* name, std::function<void()> run)
+  {
+    TestCases().push_back(TestCase{name, std::move(run)});
+  }
+};
+
+#define TEST_CONCAT2(a, b) a##b
+#define TEST_CONCAT(a, b) TEST_CONCAT2(a, b)
+
+#define TEST_CASE(name)                                                                  \
+  static void TEST_CONCAT(TestBody_, __LINE__)();                                        \
+  static TestRegistrar TEST_CONCAT(testRegistrar_, __LINE__)(name, TEST_CONCAT(TestBody_, __LINE__)); \
+  static void TEST_CONCAT(TestBody_, __LINE__)()
+
+#define CHECK(condition)                                                                 \
+  do {                                                                                   \
+    if (!(condition)) {                                                                  \
+      std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);           \
+      TestFailures()++;                                                                  \
+    }                                                                                    \
+  } while (false)
+
+#define CHECK_THROWS(statement, exception)                                               \
+  do {                                                                                   \
+    bool thrown = false;                                                                 \
+    try {                                                                                \
+      statement;                                                                         \
+    } catch (const exception&) {                                                         \
+      thrown = true;                                                                     \
+    }                                                                                    \
+    if (!thrown) {                                                                       \
+      std::printf("%s:%d: %s did not throw %s\n", __FILE__, __LINE__, #statement, #exception); \
+      TestFailures()++;                                                                  \
+    }                                                                                    \
+  } while (false)
+
+/**
+ * @brief File in the temporary directory which is removed with the object.
+ */
+class TempFile
+{
+public:
+  /**
+   * @brief Create the file with the given content.
+   * @throws std::runtime_error if the file cannot be created or written.
+   */
+  explicit TempFile(const std::string& content)
+  {
+    char path[] = "/tmp/validated_json_test_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+      throw std::runtime_error(std::string("Could not create temporary file: ") + std::strerror(errno));
+    }
+    close(fd);
+    _path = path;
+    if (!(std::ofstream(_path, std::ios::binary) << content)) {
+      std::remove(_path.c_str());
+      throw std::runtime_error("Could not write temporary file: " + _path);
+    }
+  }
+
+  ~TempFile() { std::remove(_path.c_str()); }
+
+  TempFile(const TempFile&) = delete;
+  TempFile& operator=(const TempFile&) = delete;
+
+  const std::string& Path() const { return _path; }
+
+private:
+  std::string _path;
+};
+
+/**
+ * @brief Run every registered test case, catching what escapes one.
+ * @return Exit code: 0 if every check passed.
+ */
+inline int TestMain()
+{
+  for (const TestCase& test : TestCases()) {
+    int before = TestFailures();
+    try {
+      test.run();
+    } catch (const std::exception& e) {
+      std::printf("%s: uncaught exception: %s\n", test.name, e.what());
+      TestFailures()++;
+    }
+    std::printf("%s %s\n", TestFailures() == before ? "PASS" : "FAIL", test.name);
+  }
+  return TestFailures() == 0 ? 0 : 1;
+}
+
+#endif // TEST_H
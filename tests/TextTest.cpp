@@ -0,0 +1,236 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "MyData.h"
+#include "Test.h"
+#include "ValidatedJson.h"
+
+// Binding straight from text against binding the same text from a tree.
+
+namespace
+{
+// Bound with Required() and Optional(), which read their object into a tree
+class Person : public ValidatedJson
+{
+public:
+  Person(JsonData&& data) :
+    ValidatedJson(std::move(data))
+  {
+    Required("name", _name);
+    Optional("age", _age, -1);
+    Optional("friends", _friends, std::vector<MyData2>());
+  }
+
+  std::string ToString() const
+  {
+    std::string text = _name + " " + std::to_string(_age);
+    for (const MyData2& friendData : _friends) {
+      text += " " + friendData.ToString();
+    }
+    return text;
+  }
+
+private:
+  std::string _name;
+  int _age = 0;
+  std::vector<MyData2> _friends;
+};
+
+const std::vector<std::string> kMyData = {
+  "{\"description\": \"d\", \"nested\": {\"age\": 1}, \"values\": []}",
+  "{\"name\": \"n\", \"description\": \"d\", \"nested\": {\"age\": 1}, \"values\": [1, 2, 3]}",
+  "{\"values\": [4], \"nested\": {\"age\": 2}, \"description\": \"out of order\"}",
+  "{\"extra\": {\"a\": [1, {\"b\": \"]}\"}]}, \"description\": \"d\", \"more\": [[], {}],"
+  " \"nested\": {\"skip\": true, \"age\": 3}, \"values\": [5], \"last\": null}",
+  "{\"name\": \"\\\"esc\\\\aped\\\"\\n\\u00e9\\ud83d\\ude00\", \"description\": \"d\","
+  " \"nested\": {\"age\": 4}, \"values\": []}",
+  "{\"description\": \"first\", \"description\": \"second\", \"nested\": {\"age\": 5}, \"values\": []}",
+  "{\"nested\": {\"age\": 1}, \"values\": []}",
+  "{\"description\": 7, \"nested\": {\"age\": \"x\"}, \"values\": [1, \"2\", 3.5, null]}",
+  "{\"description\": \"d\", \"nested\": [], \"values\": {}}",
+  "{\"description\": \"d\", \"nested\": {}, \"values\": [2147483648, -2147483649]}",
+  "{\"name\": null, \"description\": \"d\", \"nested\": {\"age\": 1.5}, \"values\": [true]}",
+  "[]",
+  "3",
+};
+
+// Failing documents whose members are in neither declaration nor sorted order,
+// so the error found first depends on the order fields are bound in
+const std::vector<std::string> kOutOfOrder = {
+  "{\"values\": [\"x\"], \"nested\": {\"age\": \"y\"}, \"description\": \"d\"}",
+  "{\"values\": [1, \"2\"], \"description\": 7, \"nested\": {\"age\": 1}, \"name\": 3}",
+  "{\"nested\": {\"age\": \"y\"}, \"name\": 1}",
+  "{\"values\": {}, \"extra\": [1], \"nested\": 1, \"description\": \"d\"}",
+  "{\"zz\": 0, \"values\": [], \"nested\": {\"age\": 1, \"age\": \"z\"}, \"name\": []}",
+  // The first of each duplicate is invalid, and the last is bound
+  "{\"description\": \"d\", \"nested\": {\"age\": \"x\", \"age\": 1}, \"values\": [\"x\"], \"values\": [1], "
+  "\"name\": 1}",
+};
+
+const std::vector<std::string> kPerson = {
+  "{\"name\": \"a\"}",
+  "{\"name\": \"b\", \"age\": 40, \"friends\": [{\"age\": 1}, {\"age\": 2}]}",
+  "{\"age\": 40, \"ignored\": [1, 2], \"name\": \"c\"}",
+  "{\"name\": 1, \"age\": \"x\", \"friends\": [{\"age\": \"y\"}, {}]}",
+  "{}",
+  "{\"name\": \"d\", \"friends\": [[1], 2, \"s\", null]}",
+  "[1]",
+  "[]",
+  "42",
+  "\"s\"",
+  "null",
+};
+
+const std::vector<std::string> kSyntaxErrors = {
+  "",
+  "{",
+  "{\"description\": \"d\",}",
+  "{\"description\" \"d\"}",
+  "{\"description\": \"d\", \"nested\": {\"age\": 1}, \"values\": [1,]}",
+  "{\"description\": \"d\", \"nested\": {\"age\": 01}, \"values\": []}",
+  "{\"description\": \"d\"} trailing",
+  "{\"skipped\": [1, 2}, \"description\": \"d\"}",
+  // A duplicate which is not bound is still checked
+  "{\"description\": \"d\", \"nested\": {\"age\": 1}, \"values\": [1, , 2], \"values\": [1]}",
+};
+
+/**
+ * @brief Get the message of the error constructing T throws, or an empty
+ *        string if it does not throw.
+ */
+template<typename T>
+std::string ThrownMessage(JsonData&& data)
+{
+  try {
+    T bound{std::move(data)};
+  } catch (const std::runtime_error& e) {
+    return e.what();
+  }
+  return "";
+}
+
+/**
+ * @brief Construct from a tree and from text, which both throw, and compare
+ *        what they throw.
+ */
+template<typename T>
+bool SameThrownFromTextAndTree(const std::string& text)
+{
+  std::string tree = ThrownMessage<T>(JsonString(text));
+  std::string direct = ThrownMessage<T>(JsonText(text));
+  if (tree.empty() || tree != direct) {
+    std::printf("differs: %s\n", text.c_str());
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Bind a document from a tree and from text and compare the results.
+ */
+template<typename T>
+bool SameFromTextAndTree(const std::string& text, ValidationMode mode)
+{
+  ValidationResult<T> tree = Validate<T>(std::string_view(text), mode);
+  ValidationResult<T> direct = ValidateText<T>(text, mode);
+  bool same = tree.Ok() == direct.Ok() && tree.Errors().size() == direct.Errors().size();
+  if (same && tree.Ok()) {
+    same = tree.Value().ToString() == direct.Value().ToString();
+  }
+  for (size_t i = 0; same && i < tree.Errors().size(); i++) {
+    same = tree.Errors()[i].message == direct.Errors()[i].message &&
+           tree.Errors()[i].path == direct.Errors()[i].path;
+  }
+  if (!same) {
+    std::printf("differs: %s\n", text.c_str());
+  }
+  return same;
+}
+}
+
+TEST_CASE("Bind() classes bind the same from text as from a tree")
+{
+  for (const std::string& text : kMyData) {
+    CHECK(SameFromTextAndTree<MyData>(text, ValidationMode::FirstError));
+    CHECK(SameFromTextAndTree<MyData>(text, ValidationMode::AllErrors));
+  }
+  // Every wrong value is reported, not just the first
+  CHECK(ValidateText<MyData>(kMyData[7], ValidationMode::AllErrors).Errors().size() == 5);
+}
+
+TEST_CASE("fields are bound in declaration order whatever the order of the members")
+{
+  for (const std::string& text : kOutOfOrder) {
+    CHECK(SameThrownFromTextAndTree<MyData>(text));
+    CHECK(SameFromTextAndTree<MyData>(text, ValidationMode::FirstError));
+    CHECK(SameFromTextAndTree<MyData>(text, ValidationMode::AllErrors));
+  }
+
+  // nested is declared before values, and is reported first from both
+  for (bool fromText : {false, true}) {
+    auto validate = [&](const std::string& text, ValidationMode mode) {
+      return fromText ? ValidateText<MyData>(text, mode) : Validate<MyData>(std::string_view(text), mode);
+    };
+    auto first = validate(kOutOfOrder[0], ValidationMode::FirstError);
+    CHECK(first.Errors().size() == 1);
+    CHECK(first.Errors()[0].path == "/nested/age");
+    CHECK(first.Errors()[0].message == "Expected integer value for key: age");
+
+    auto all = validate(kOutOfOrder[1], ValidationMode::AllErrors);
+    CHECK(all.Errors().size() == 3);
+    CHECK(all.Errors()[0].path == "/name");
+    CHECK(all.Errors()[0].message == "Expected string value for key: name");
+    CHECK(all.Errors()[1].path == "/description");
+    CHECK(all.Errors()[2].path == "/values/1");
+
+    // Missing fields are reported in their place among the others
+    auto missing = validate(kOutOfOrder[2], ValidationMode::AllErrors);
+    CHECK(missing.Errors().size() == 4);
+    CHECK(missing.Errors()[0].path == "/name");
+    CHECK(missing.Errors()[1].path == "/description");
+    CHECK(missing.Errors()[1].message == "Required key \"description\" not found");
+    CHECK(missing.Errors()[2].path == "/nested/age");
+    CHECK(missing.Errors()[3].path == "/values");
+
+    // Only the name is wrong: the invalid duplicates are not bound
+    auto duplicates = validate(kOutOfOrder[5], ValidationMode::AllErrors);
+    CHECK(duplicates.Errors().size() == 1);
+    CHECK(duplicates.Errors()[0].path == "/name");
+  }
+  CHECK(ThrownMessage<MyData>(JsonString(kOutOfOrder[0])) == "Expected integer value for key: age");
+  CHECK(ThrownMessage<MyData>(JsonText(kOutOfOrder[0])) == "Expected integer value for key: age");
+}
+
+TEST_CASE("Required() and Optional() classes bind the same from text as from a tree")
+{
+  for (const std::string& text : kPerson) {
+    CHECK(SameFromTextAndTree<Person>(text, ValidationMode::FirstError));
+    CHECK(SameFromTextAndTree<Person>(text, ValidationMode::AllErrors));
+  }
+
+  // A value which is not an object has no members, as for Bind() classes
+  for (const char* text : {"[1]", "42", "\"s\""}) {
+    ValidationResult<Person> tree = Validate<Person>(std::string_view(text));
+    CHECK(tree.Errors().size() == 1 && tree.Errors()[0].path == "/name");
+    CHECK(tree.Errors()[0].message == "Required key \"name\" not found");
+    CHECK(ValidateText<Person>(text).Errors().size() == 1);
+    CHECK(SameThrownFromTextAndTree<Person>(text));
+    CHECK(ThrownMessage<Person>(JsonText(text)) == "Required key \"name\" not found");
+  }
+}
+
+TEST_CASE("syntax errors fail binding from text")
+{
+  for (const std::string& text : kSyntaxErrors) {
+    CHECK(!ValidateText<MyData>(text, ValidationMode::AllErrors).Ok());
+    CHECK_THROWS(MyData{JsonText(text)}, std::runtime_error);
+  }
+}
+
+TEST_CASE("constructing from text throws the first validation error")
+{
+  MyData bound{JsonText(kMyData[1])};
+  CHECK(bound.ToString() == MyData{JsonString(kMyData[1])}.ToString());
+  CHECK_THROWS(MyData{JsonText(kMyData[6])}, std::runtime_error);
+}
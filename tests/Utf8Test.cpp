@@ -0,0 +1,163 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "JsonParser.h"
+#include "Test.h"
+#include "Utf8Validator.h"
+
+// UTF-8 validation by every kernel against a decoding reference.
+
+namespace
+{
+const Utf8Validator::Kernel kKernels[] = {
+  Utf8Validator::Kernel::Scalar, Utf8Validator::Kernel::Sse42, Utf8Validator::Kernel::Avx2
+};
+
+/**
+ * @brief Decode text, checking that each code point is encoded in the
+ *        fewest bytes, is not a surrogate and is at most U+10FFFF.
+ * @return Offset of the first invalid sequence, or the size if there is none.
+ */
+size_t ReferenceInvalid(const std::string& text)
+{
+  const unsigned char* s = reinterpret_cast<const unsigned char*>(text.data());
+  size_t i = 0;
+  while (i < text.size()) {
+    size_t length = s[i] < 0x80 ? 1 : (s[i] >> 5) == 0x6 ? 2 : (s[i] >> 4) == 0xE ? 3 : (s[i] >> 3) == 0x1E ? 4 : 0;
+    if (length == 0 || i + length > text.size()) {
+      return i;
+    }
+    uint32_t codePoint = length == 1 ? s[i] : s[i] & (0x7F >> length);
+    for (size_t k = 1; k < length; k++) {
+      if ((s[i + k] & 0xC0) != 0x80) {
+        return i;
+      }
+      codePoint = codePoint << 6 | (s[i + k] & 0x3F);
+    }
+    static const uint32_t kSmallest[] = {0, 0, 0x80, 0x800, 0x10000};
+    if (codePoint < kSmallest[length] || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+      return i;
+    }
+    i += length;
+  }
+  return text.size();
+}
+
+/**
+ * @brief Check every supported kernel, and FindInvalid(), against the reference.
+ */
+bool ValidMatches(const std::string& text)
+{
+  size_t expected = ReferenceInvalid(text);
+  bool same = Utf8Validator::FindInvalid(text.data(), text.size()) == expected;
+  for (Utf8Validator::Kernel kernel : kKernels) {
+    if (Utf8Validator::Supported(kernel)) {
+      same = same && Utf8Validator::Valid(text.data(), text.size(), kernel) == (expected == text.size());
+    }
+  }
+  if (!same) {
+    std::printf("differs on %zu bytes, first invalid at %zu\n", text.size(), expected);
+  }
+  return same;
+}
+
+const std::vector<std::string> kValid = {
+  "\x7F",
+  "\xC2\x80", "\xDF\xBF",                           // Two bytes
+  "\xE0\xA0\x80", "\xED\x9F\xBF", "\xEE\x80\x80",   // Three bytes, around the surrogates
+  "\xEF\xBF\xBF",
+  "\xF0\x90\x80\x80", "\xF4\x8F\xBF\xBF",           // Four bytes, up to U+10FFFF
+};
+
+const std::vector<std::string> kInvalid = {
+  "\x80", "\xBF",                                   // Stray continuations
+  "\xC0\x80", "\xC1\xBF",                           // Overlong two bytes
+  "\xE0\x80\x80", "\xE0\x9F\xBF",                   // Overlong three bytes
+  "\xF0\x80\x80\x80", "\xF0\x8F\xBF\xBF",           // Overlong four bytes
+  "\xED\xA0\x80", "\xED\xBF\xBF",                   // Surrogates
+  "\xF4\x90\x80\x80", "\xF5\x80\x80\x80",           // Above U+10FFFF
+  "\xF8\x88\x80\x80\x80", "\xFE", "\xFF",           // Never valid
+  "\xC3", "\xE2\x82", "\xF0\x9F\x98",               // Truncated
+  "\xC3\x41", "\xE2\x41\x82", "\xF0\x9F\x41\x80",   // Interrupted
+};
+}
+
+TEST_CASE("sequences are accepted and rejected at every offset in a block")
+{
+  for (size_t offset = 0; offset < 130; offset++) {
+    for (const std::string& sequence : kValid) {
+      std::string text = std::string(offset, 'a') + sequence + std::string(offset % 7, 'b');
+      CHECK(ValidMatches(text));
+      CHECK(ReferenceInvalid(text) == text.size());
+    }
+    for (const std::string& sequence : kInvalid) {
+      std::string text = std::string(offset, 'a') + sequence + std::string(offset % 7, 'b');
+      CHECK(ValidMatches(text));
+      CHECK(Utf8Validator::FindInvalid(text.data(), text.size()) == offset);
+    }
+    // Truncated at the very end of the text
+    for (const char* sequence : {"\xC3", "\xE2\x82", "\xF0\x9F\x98"}) {
+      std::string text = std::string(offset, 'a') + sequence;
+      CHECK(ValidMatches(text));
+    }
+  }
+}
+
+TEST_CASE("every kernel matches the reference on random text")
+{
+  std::mt19937 random(16);
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::uniform_int_distribution<int> ascii(0, 9);
+  for (int i = 0; i < 2000; i++) {
+    std::string text;
+    size_t size = i % 300;
+    while (text.size() < size) {
+      // Mostly valid sequences, so that an error may come late
+      if (ascii(random) < 6) {
+        text += static_cast<char>('a' + ascii(random));
+      } else if (ascii(random) < 9) {
+        text += kValid[byte(random) % kValid.size()];
+      } else {
+        text += static_cast<char>(byte(random));
+      }
+    }
+    CHECK(ValidMatches(text));
+  }
+}
+
+TEST_CASE("SequenceLength() reports the length of valid sequences only")
+{
+  for (const std::string& sequence : kValid) {
+    CHECK(Utf8Validator::SequenceLength(sequence.data(), sequence.data() + sequence.size()) == sequence.size());
+  }
+  for (const std::string& sequence : kInvalid) {
+    CHECK(Utf8Validator::SequenceLength(sequence.data(), sequence.data() + sequence.size()) == 0);
+  }
+}
+
+TEST_CASE("parsers reject invalid UTF-8 in strings whichever way it is checked")
+{
+  for (JsonBackend backend : {JsonBackend::Jsoncpp, JsonBackend::Builtin}) {
+    for (Utf8Validation utf8 : {Utf8Validation::PerString, Utf8Validation::Buffer}) {
+      JsonParserSettings settings;
+      settings.backend = backend;
+      settings.utf8 = utf8;
+      JsonParser parser(settings);
+      for (const std::string& sequence : kValid) {
+        std::string text = "[\"" + sequence + "\"]";
+        Json::Value root;
+        std::string errors;
+        CHECK(parser.Parse(text.data(), text.data() + text.size(), root, errors));
+        CHECK(root[0].asString() == sequence);
+      }
+      for (const std::string& sequence : kInvalid) {
+        std::string text = "[\"" + sequence + "\"]";
+        Json::Value root;
+        std::string errors;
+        CHECK(!parser.Parse(text.data(), text.data() + text.size(), root, errors));
+      }
+    }
+  }
+}
@@ -0,0 +1,144 @@
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "MyData.h"
+#include "Test.h"
+#include "ValidateBatch.h"
+
+// ValidateBatch() against binding the same documents one by one.
+
+namespace
+{
+std::vector<std::string> MakeDocuments(size_t count)
+{
+  std::vector<std::string> documents;
+  for (size_t i = 0; i < count; i++) {
+    std::string age = i % 5 == 0 ? "\"old\"" : std::to_string(i);
+    documents.push_back("{\"description\": \"doc " + std::to_string(i) + "\", \"nested\": {\"age\": " + age +
+                        "}, \"values\": [" + std::to_string(i) + "]}");
+  }
+  return documents;
+}
+
+// Read into a tree by Required(), so its array can be bound in parallel
+class Group : public ValidatedJson
+{
+public:
+  Group(JsonData&& data) :
+    ValidatedJson(std::move(data))
+  {
+    Required("members", _members);
+  }
+
+  std::string ToString() const
+  {
+    std::string text;
+    for (const MyData2& member : _members) {
+      text += member.ToString();
+    }
+    return text;
+  }
+
+private:
+  std::vector<MyData2> _members;
+};
+
+template<typename T = MyData>
+bool SameAsOneByOne(const std::vector<std::string_view>& documents,
+                    const std::vector<ValidationResult<T>>& results,
+                    JsonParser& parser = JsonParser::ThreadLocal())
+{
+  if (results.size() != documents.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < documents.size(); i++) {
+    ValidationResult<T> expected = ValidateText<T>(documents[i], ValidationMode::FirstError, parser);
+    if (results[i].Ok() != expected.Ok()) {
+      return false;
+    }
+    if (expected.Ok() ? results[i].Value().ToString() != expected.Value().ToString()
+                      : results[i].Errors()[0].path != expected.Errors()[0].path) {
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+TEST_CASE("results are in document order")
+{
+  std::vector<std::string> texts = MakeDocuments(1000);
+  std::vector<std::string_view> documents(texts.begin(), texts.end());
+  ThreadPool pool(4);
+  CHECK(SameAsOneByOne(documents, ValidateBatch<MyData>(documents, ValidationMode::FirstError,
+                                                        JsonParser::ThreadLocal(), pool)));
+}
+
+TEST_CASE("two threads share one pool")
+{
+  std::vector<std::string> texts = MakeDocuments(2000);
+  std::vector<std::string_view> documents(texts.begin(), texts.end());
+  ThreadPool pool(4);
+
+  std::vector<ValidationResult<MyData>> first;
+  std::vector<ValidationResult<MyData>> second;
+  for (int round = 0; round < 20; round++) {
+    std::thread a([&] {
+      first = ValidateBatch<MyData>(documents, ValidationMode::FirstError, JsonParser::ThreadLocal(), pool);
+    });
+    std::thread b([&] {
+      second = ValidateBatch<MyData>(documents, ValidationMode::AllErrors, JsonParser::ThreadLocal(), pool);
+    });
+    a.join();
+    b.join();
+  }
+  CHECK(SameAsOneByOne(documents, first));
+  CHECK(second.size() == documents.size());
+  CHECK(!second[0].Ok() && second[0].Errors()[0].path == "/nested/age");
+  CHECK(second[1].Ok());
+}
+
+TEST_CASE("buffers kept per worker read every document as fresh ones do")
+{
+  // Indexed, with escaped names of every length, so each document grows or
+  // reuses the buffers the last one on its worker left
+  JsonParserSettings settings;
+  settings.structuralIndex = true;
+  JsonParser parser(settings);
+  std::vector<std::string> texts;
+  for (size_t i = 0; i < 500; i++) {
+    texts.push_back("{\"name\": \"" + std::string(i % 37, 'n') + std::string(2 * (i % 5), '\\') +
+                    "\\n\", \"description\": \"d\", \"nested\": {\"age\": " +
+                    (i % 7 == 0 ? std::string("\"old\"") : std::to_string(i)) + "}, \"values\": [" +
+                    std::string(i % 11 ? "1" : "\"x\"") + "]}");
+  }
+  std::vector<std::string_view> documents(texts.begin(), texts.end());
+  ThreadPool pool(4);
+  CHECK(SameAsOneByOne(documents, ValidateBatch<MyData>(documents, ValidationMode::FirstError, parser, pool),
+                       parser));
+}
+
+TEST_CASE("ranges run from a nested Run() read in buffers of their own")
+{
+  std::vector<std::string> texts;
+  for (size_t i = 0; i < 200; i++) {
+    std::string members;
+    for (size_t j = 0; j < 16; j++) {
+      bool bad = i % 9 == 0 && j == i % 16;
+      members += (j ? ", " : "") + std::string("{\"age\": ") + (bad ? "\"x\"" : std::to_string(j)) + "}";
+    }
+    texts.push_back("{\"members\": [" + members + "]}");
+  }
+  std::vector<std::string_view> documents(texts.begin(), texts.end());
+  ThreadPool pool(4);
+
+  // Arrays of members are split on the same pool, whose workers may then run
+  // another range of the batch in the middle of a document
+  ValidatedJson::SetParallelArrays(4, &pool);
+  std::vector<ValidationResult<Group>> results = ValidateBatch<Group>(documents, ValidationMode::FirstError,
+                                                                      JsonParser::ThreadLocal(), pool);
+  ValidatedJson::SetParallelArrays(0);
+  CHECK(SameAsOneByOne<Group>(documents, results));
+}
@@ -0,0 +1,137 @@
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MyData.h"
+#include "Test.h"
+#include "ValidatedJson.h"
+
+// JSON Pointer paths of the errors Validate() collects, from a tree and from
+// text.
+
+namespace
+{
+// Keys which have to be escaped in a JSON Pointer
+class Escaped : public ValidatedJson
+{
+public:
+  Escaped(JsonData&& data) :
+    ValidatedJson(std::move(data))
+  {
+    Bind(*this);
+  }
+
+  static constexpr auto Fields()
+  {
+    return FieldList(Required("a/b", &Escaped::_slash),
+                     Required("m~n", &Escaped::_tilde),
+                     Required("~/~", &Escaped::_both));
+  }
+
+private:
+  int _slash = 0;
+  int _tilde = 0;
+  int _both = 0;
+};
+
+// Tree of nodes, for paths of any depth
+class Node : public ValidatedJson
+{
+public:
+  Node(JsonData&& data) :
+    ValidatedJson(std::move(data))
+  {
+    Optional("children", _children, std::vector<Node>());
+    Optional("value", _value, 0);
+  }
+
+  Node() {}
+
+private:
+  std::vector<Node> _children;
+  int _value = 0;
+};
+
+/**
+ * @brief Make a chain of nodes depth deep, with a string as the value of the
+ *        deepest, and the path to that value.
+ */
+std::string MakeChain(size_t depth, std::string& path)
+{
+  std::string json = "{\"value\": \"deep\"}";
+  path = "/value";
+  for (size_t i = 0; i < depth; i++) {
+    json = "{\"children\": [{}, " + json + "]}";
+    path = "/children/1" + path;
+  }
+  return json;
+}
+
+/**
+ * @brief Validate a document from a tree and from text, and get the paths of
+ *        the errors, which must be the same from both.
+ */
+template<typename T>
+std::vector<std::string> ErrorPaths(const std::string& text, ValidationMode mode = ValidationMode::AllErrors)
+{
+  ValidationResult<T> tree = Validate<T>(std::string_view(text), mode);
+  ValidationResult<T> direct = ValidateText<T>(text, mode);
+  std::vector<std::string> paths;
+  for (const ValidationError& error : tree.Errors()) {
+    paths.push_back(error.path);
+  }
+  std::vector<std::string> directPaths;
+  for (const ValidationError& error : direct.Errors()) {
+    directPaths.push_back(error.path);
+  }
+  if (paths != directPaths) {
+    std::printf("paths differ: %s\n", text.c_str());
+    return {};
+  }
+  return paths;
+}
+
+using Paths = std::vector<std::string>;
+}
+
+TEST_CASE("array elements are reported at their index")
+{
+  CHECK(ErrorPaths<MyData>("{\"description\": \"d\", \"nested\": {\"age\": 1}, \"values\": [1, \"x\", 3]}") ==
+        Paths{"/values/1"});
+  CHECK(ErrorPaths<MyData>("{\"description\": \"d\", \"nested\": {\"age\": 1}, \"values\": [true, 2, null]}") ==
+        (Paths{"/values/0", "/values/2"}));
+}
+
+TEST_CASE("missing required keys are reported where they should be")
+{
+  CHECK(ErrorPaths<MyData>("{\"description\": \"d\", \"values\": []}") == Paths{"/nested"});
+  CHECK(ErrorPaths<MyData>("{\"description\": \"d\", \"nested\": {}, \"values\": []}") == Paths{"/nested/age"});
+  CHECK(ErrorPaths<MyData>("{}") == (Paths{"/description", "/nested", "/values"}));
+
+  ValidationResult<MyData> result = Validate<MyData>(std::string_view("{\"description\": \"d\", \"values\": []}"));
+  CHECK(result.Errors().size() == 1);
+  CHECK(result.Errors()[0].message == "Required key \"nested\" not found");
+}
+
+TEST_CASE("'~' and '/' in keys are escaped")
+{
+  CHECK(ErrorPaths<Escaped>("{\"a/b\": \"x\", \"m~n\": \"y\", \"~/~\": \"z\"}") ==
+        (Paths{"/a~1b", "/m~0n", "/~0~1~0"}));
+  // Missing keys are escaped too
+  CHECK(ErrorPaths<Escaped>("{\"a/b\": 1}") == (Paths{"/m~0n", "/~0~1~0"}));
+}
+
+TEST_CASE("paths deeper than the inline stack are reported whole")
+{
+  for (size_t depth : {15, 16, 17, 40}) {
+    std::string path;
+    std::string json = MakeChain(depth, path);
+    CHECK(ErrorPaths<Node>(json) == Paths{path});
+    CHECK(ErrorPaths<Node>(json, ValidationMode::FirstError) == Paths{path});
+
+    // Once the deep error is reported, the path unwinds back to the root
+    std::string after = "{\"children\": [" + json + "], \"value\": \"top\"}";
+    CHECK(ErrorPaths<Node>(after) == (Paths{"/children/0" + path, "/value"}));
+  }
+}